@@ -98,6 +98,21 @@ static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
  */
 static const wxChar ShowRouterDebugGraphics[] = wxT( "ShowRouterDebugGraphics" );
 
+/**
+ * Walk around obstacles in both directions on separate threads in the router
+ */
+static const wxChar RouterParallelWalkaround[] = wxT( "RouterParallelWalkaround" );
+
+/**
+ * Optimize routed tracks once more after they are committed, as a separate undo step
+ */
+static const wxChar RouterDeferredOptimization[] = wxT( "RouterDeferredOptimization" );
+
+/**
+ * Compare the incrementally updated router world against a full sync, for debugging
+ */
+static const wxChar RouterCheckWorldSync[] = wxT( "RouterCheckWorldSync" );
+
 /**
  * When set to true, this will wrap polygon point sets at 4 points per line rather
  * than a single point per line.  Single point per line helps with version control systems
@@ -230,6 +245,9 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_RealTimeConnectivity      = true;
     m_CoroutineStackSize        = AC_STACK::default_stack;
     m_ShowRouterDebugGraphics   = false;
+    m_RouterParallelWalkaround  = true;
+    m_RouterDeferredOptimization = false;
+    m_RouterCheckWorldSync      = false;
     m_DrawArcAccuracy           = 10.0;
     m_DrawArcCenterMaxAngle     = 50.0;
     m_DrawTriangulationOutlines = false;
@@ -308,6 +326,15 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ShowRouterDebugGraphics,
                                                 &m_ShowRouterDebugGraphics, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RouterParallelWalkaround,
+                                                &m_RouterParallelWalkaround, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RouterDeferredOptimization,
+                                                &m_RouterDeferredOptimization, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RouterCheckWorldSync,
+                                                &m_RouterCheckWorldSync, false ) );
+
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CompactFileSave,
                                                 &m_CompactSave, false ) );
 
@@ -348,6 +348,18 @@ const FOOTPRINT* FP_LIB_TABLE::GetEnumeratedFootprint( const wxString& aNickname
 }
 
 
+bool FP_LIB_TABLE::GetFootprintMetadata( const wxString& aNickname,
+                                         const wxString& aFootprintName,
+                                         FOOTPRINT_METADATA& aMetadata )
+{
+    const FP_LIB_TABLE_ROW* row = FindRow( aNickname, true );
+    wxASSERT( (PLUGIN*) row->plugin );
+
+    return row->plugin->GetFootprintMetadata( row->GetFullURI( true ), aFootprintName,
+                                              aMetadata, row->GetProperties() );
+}
+
+
 bool FP_LIB_TABLE::FootprintExists( const wxString& aNickname, const wxString& aFootprintName )
 {
     try
@@ -34,12 +34,26 @@
 #include <boost/uuid/entropy_error.hpp>
 #endif
 
+#include <mutex>
+
 #include <wx/log.h>
 
 
 // Create only once, as seeding is *very* expensive
 static boost::uuids::random_generator randomGenerator;
 
+// The generator is not thread safe, and items are created on worker threads by the file
+// loaders.
+static std::mutex randomGeneratorMutex;
+
+
+static boost::uuids::uuid newRandomUuid()
+{
+    std::lock_guard<std::mutex> lock( randomGeneratorMutex );
+
+    return randomGenerator();
+}
+
 // These don't have the same performance penalty, but might as well be consistent
 static boost::uuids::string_generator stringGenerator;
 static boost::uuids::nil_generator    nilGenerator;
@@ -65,7 +79,7 @@ KIID::KIID()
     {
 #endif
 
-        m_uuid = randomGenerator();
+        m_uuid = newRandomUuid();
 
 #if BOOST_VERSION >= 106700
     }
@@ -117,7 +131,7 @@ KIID::KIID( const wxString& aString ) : m_uuid(), m_cached_timestamp( 0 )
             {
 #endif
 
-                m_uuid = randomGenerator();
+                m_uuid = newRandomUuid();
 
 #if BOOST_VERSION >= 106700
             }
@@ -228,7 +242,7 @@ void KIID::ConvertTimestampToUuid()
         return;
 
     m_cached_timestamp = 0;
-    m_uuid             = randomGenerator();
+    m_uuid             = newRandomUuid();
 }
 
 
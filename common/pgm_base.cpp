@@ -45,6 +45,7 @@
 #include <config_params.h>
 #include <confirm.h>
 #include <core/arraydim.h>
+#include <core/thread_pool.h>
 #include <dialogs/dialog_configure_paths.h>
 #include <eda_base_frame.h>
 #include <eda_draw_frame.h>
@@ -134,6 +135,9 @@ void PGM_BASE::Destroy()
 
     delete m_locale;
     m_locale = 0;
+
+    // Join the workers now: joining threads during static destruction can deadlock on MSW.
+    THREAD_POOL::GetInstance().Shutdown();
 }
 
 
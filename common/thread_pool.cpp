@@ -0,0 +1,181 @@
+/*
+* This program source code file is part of KiCad, a free EDA CAD application.
+*
+* Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the
+* Free Software Foundation, either version 3 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <core/thread_pool.h>
+
+#include <algorithm>
+
+
+// Set while a thread runs tasks of a batch, so that nested batches do not wait for themselves
+static thread_local bool t_inBatch = false;
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreads ) :
+        m_func( nullptr ),
+        m_count( 0 ),
+        m_next( 0 ),
+        m_generation( 0 ),
+        m_busy( 0 ),
+        m_quit( false )
+{
+    for( size_t ii = 0; ii < aThreads; ++ii )
+        m_threads.emplace_back( &THREAD_POOL::workerLoop, this );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    Shutdown();
+}
+
+
+void THREAD_POOL::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_quit = true;
+    }
+
+    m_wake.notify_all();
+
+    for( std::thread& thread : m_threads )
+        thread.join();
+
+    m_threads.clear();
+}
+
+
+THREAD_POOL& THREAD_POOL::GetInstance()
+{
+    // The calling thread runs tasks too
+    static THREAD_POOL pool( std::max( 1u, std::thread::hardware_concurrency() ) - 1 );
+
+    return pool;
+}
+
+
+void THREAD_POOL::ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc )
+{
+    if( aCount == 0 )
+        return;
+
+    if( m_threads.empty() || aCount == 1 || t_inBatch )
+    {
+        for( size_t i = 0; i < aCount; ++i )
+            aFunc( i );
+
+        return;
+    }
+
+    std::lock_guard<std::mutex> batchLock( m_batchMutex );
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        m_func = &aFunc;
+        m_count = aCount;
+        m_next = 0;
+        m_generation++;
+    }
+
+    m_wake.notify_all();
+
+    std::exception_ptr exception;
+
+    t_inBatch = true;
+
+    try
+    {
+        for( size_t i = m_next++; i < aCount; i = m_next++ )
+            aFunc( i );
+    }
+    catch( ... )
+    {
+        exception = std::current_exception();
+        m_next = aCount;
+    }
+
+    t_inBatch = false;
+
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    m_done.wait( lock, [this]() { return m_busy == 0; } );
+
+    // Workers waking up from now on must not join the finished batch
+    m_func = nullptr;
+
+    if( !exception )
+        exception = m_exception;
+
+    m_exception = nullptr;
+
+    if( exception )
+        std::rethrow_exception( exception );
+}
+
+
+void THREAD_POOL::workerLoop()
+{
+    size_t seen = 0;
+
+    t_inBatch = true;
+
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    while( true )
+    {
+        m_wake.wait( lock, [&]() { return m_quit || m_generation != seen; } );
+
+        if( m_quit )
+            return;
+
+        seen = m_generation;
+
+        if( !m_func )
+            continue;
+
+        const std::function<void( size_t )>* func = m_func;
+        size_t                               count = m_count;
+
+        std::exception_ptr exception;
+
+        m_busy++;
+        lock.unlock();
+
+        try
+        {
+            for( size_t i = m_next++; i < count; i = m_next++ )
+                ( *func )( i );
+        }
+        catch( ... )
+        {
+            // Stop the batch; the caller rethrows the exception
+            exception = std::current_exception();
+            m_next = count;
+        }
+
+        lock.lock();
+
+        if( exception && !m_exception )
+            m_exception = exception;
+
+        if( --m_busy == 0 )
+            m_done.notify_all();
+    }
+}
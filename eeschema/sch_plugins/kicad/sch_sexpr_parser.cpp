@@ -61,7 +61,9 @@ SCH_SEXPR_PARSER::SCH_SEXPR_PARSER( LINE_READER* aLineReader ) :
     m_requiredVersion( 0 ),
     m_fieldId( 0 ),
     m_unit( 1 ),
-    m_convert( 1 )
+    m_convert( 1 ),
+    m_deferredItems( nullptr ),
+    m_deferredImages( nullptr )
 {
 }
 
@@ -2070,11 +2072,11 @@ void SCH_SEXPR_PARSER::ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly,
         }
 
         case T_symbol:
-            screen->Append( static_cast<SCH_ITEM*>( parseSchematicSymbol() ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( parseSchematicSymbol() ) );
             break;
 
         case T_image:
-            screen->Append( static_cast<SCH_ITEM*>( parseImage() ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( parseImage() ) );
             break;
 
         case T_sheet:
@@ -2087,33 +2089,33 @@ void SCH_SEXPR_PARSER::ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly,
             // Complex hierarchies can have multiple copies of a sheet.  This only
             // provides a simple tree to find the root sheet.
             sheet->SetParent( aSheet );
-            screen->Append( static_cast<SCH_ITEM*>( sheet ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( sheet ) );
             break;
         }
 
         case T_junction:
-            screen->Append( static_cast<SCH_ITEM*>( parseJunction() ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( parseJunction() ) );
             break;
 
         case T_no_connect:
-            screen->Append( static_cast<SCH_ITEM*>( parseNoConnect() ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( parseNoConnect() ) );
             break;
 
         case T_bus_entry:
-            screen->Append( static_cast<SCH_ITEM*>( parseBusEntry() ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( parseBusEntry() ) );
             break;
 
         case T_polyline:
         case T_bus:
         case T_wire:
-            screen->Append( static_cast<SCH_ITEM*>( parseLine() ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( parseLine() ) );
             break;
 
         case T_text:
         case T_label:
         case T_global_label:
         case T_hierarchical_label:
-            screen->Append( static_cast<SCH_ITEM*>( parseSchText() ) );
+            appendItem( screen, static_cast<SCH_ITEM*>( parseSchText() ) );
             break;
 
         case T_sheet_instances:
@@ -2144,7 +2146,17 @@ void SCH_SEXPR_PARSER::ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly,
         }
     }
 
-    screen->UpdateLocalLibSymbolLinks();
+    if( !m_deferredItems )
+        screen->UpdateLocalLibSymbolLinks();
+}
+
+
+void SCH_SEXPR_PARSER::appendItem( SCH_SCREEN* aScreen, SCH_ITEM* aItem )
+{
+    if( m_deferredItems )
+        m_deferredItems->push_back( aItem );
+    else
+        aScreen->Append( aItem );
 }
 
 
@@ -2441,12 +2453,12 @@ SCH_BITMAP* SCH_SEXPR_PARSER::parseImage()
             }
 
             wxMemoryBuffer buffer = wxBase64Decode( data );
-            wxMemoryOutputStream stream( buffer.GetData(), buffer.GetBufSize() );
-            wxImage* image = new wxImage();
-            wxMemoryInputStream istream( stream );
-            image->LoadFile( istream, wxBITMAP_TYPE_PNG );
-            bitmap->GetImage()->SetImage( image );
-            bitmap->GetImage()->SetBitmap( new wxBitmap( *image ) );
+
+            if( m_deferredImages )
+                m_deferredImages->push_back( { bitmap.get(), buffer } );
+            else
+                SetImageData( bitmap.get(), buffer );
+
             break;
         }
 
@@ -2459,6 +2471,17 @@ SCH_BITMAP* SCH_SEXPR_PARSER::parseImage()
 }
 
 
+void SCH_SEXPR_PARSER::SetImageData( SCH_BITMAP* aBitmap, const wxMemoryBuffer& aData )
+{
+    wxMemoryOutputStream stream( aData.GetData(), aData.GetBufSize() );
+    wxImage* image = new wxImage();
+    wxMemoryInputStream istream( stream );
+    image->LoadFile( istream, wxBITMAP_TYPE_PNG );
+    aBitmap->GetImage()->SetImage( image );
+    aBitmap->GetImage()->SetBitmap( new wxBitmap( *image ) );
+}
+
+
 SCH_SHEET* SCH_SEXPR_PARSER::parseSheet()
 {
     wxCHECK_MSG( CurTok() == T_sheet, nullptr,
@@ -39,6 +39,8 @@
 #include <sch_file_versions.h>
 #include <default_values.h>    // For some default values
 
+#include <wx/buffer.h>
+
 
 class LIB_ARC;
 class LIB_BEZIER;
@@ -52,6 +54,7 @@ class SCH_BITMAP;
 class SCH_BUS_WIRE_ENTRY;
 class SCH_COMPONENT;
 class SCH_FIELD;
+class SCH_ITEM;
 class SCH_JUNCTION;
 class SCH_LINE;
 class SCH_NO_CONNECT;
@@ -76,6 +79,20 @@ public:
 /**
  * Object to parser s-expression symbol library and schematic file formats.
  */
+/**
+ * An image parsed by a #SCH_SEXPR_PARSER with deferred items.
+ *
+ * Only the decoded PNG data is kept by the parser: wxImage and wxBitmap are GDI objects which
+ * must not be created on worker threads.  The caller builds the bitmap on the main thread with
+ * SCH_SEXPR_PARSER::SetImageData().
+ */
+struct SCH_SEXPR_DEFERRED_IMAGE
+{
+    SCH_BITMAP*    m_Bitmap;
+    wxMemoryBuffer m_Data;
+};
+
+
 class SCH_SEXPR_PARSER : public SCHEMATIC_LEXER
 {
     int m_requiredVersion;  ///< Set to the symbol library file version required.
@@ -84,6 +101,12 @@ class SCH_SEXPR_PARSER : public SCHEMATIC_LEXER
     int m_convert;          ///< The current body style being parsed.
     wxString m_symbolName;  ///< The current symbol name.
 
+    /// If not null, receives the parsed schematic items instead of the screen.
+    std::vector<SCH_ITEM*>* m_deferredItems;
+
+    /// Receives the image data of the deferred bitmaps.
+    std::vector<SCH_SEXPR_DEFERRED_IMAGE>* m_deferredImages;
+
     void parseHeader( TSCHEMATIC_T::T aHeaderType, int aFileVersion );
 
     inline long parseHex()
@@ -200,6 +223,8 @@ class SCH_SEXPR_PARSER : public SCHEMATIC_LEXER
     SCH_TEXT* parseSchText();
     void parseBusAlias( SCH_SCREEN* aScreen );
 
+    void appendItem( SCH_SCREEN* aScreen, SCH_ITEM* aItem );
+
 public:
     SCH_SEXPR_PARSER( LINE_READER* aLineReader = nullptr );
 
@@ -230,6 +255,30 @@ public:
     void ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyablyOnly = false,
                          int aFileVersion = SEXPR_SCHEMATIC_FILE_VERSION );
 
+    /**
+     * Have ParseSchematic() store the schematic items it parses in \a aItems rather than
+     * appending them to the screen.
+     *
+     * Appending an item to a screen computes its bounding box, which is not thread safe, so
+     * schematics parsed on worker threads must be appended to their screen on the main
+     * thread.  The caller takes ownership of the items, adds them to the screen with
+     * SCH_SCREEN::Append() and then calls SCH_SCREEN::UpdateLocalLibSymbolLinks().
+     *
+     * For the same reason the images are stored in \a aImages without their bitmap, which the
+     * caller must set with SetImageData() before appending them.
+     */
+    void SetDeferredItems( std::vector<SCH_ITEM*>* aItems,
+                           std::vector<SCH_SEXPR_DEFERRED_IMAGE>* aImages )
+    {
+        m_deferredItems = aItems;
+        m_deferredImages = aImages;
+    }
+
+    /**
+     * Build the image and bitmap of \a aBitmap from the PNG data \a aData.
+     */
+    static void SetImageData( SCH_BITMAP* aBitmap, const wxMemoryBuffer& aData );
+
     /**
      * Return whether a version number, if any was parsed, was too recent
      */
@@ -20,6 +20,11 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <map>
+#include <thread>
 
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
@@ -38,6 +43,7 @@
 #include <sch_line.h>
 #include <sch_no_connect.h>
 #include <sch_text.h>
+#include <template_fieldnames.h>
 #include <sch_sheet.h>
 #include <schematic.h>
 #include <sch_plugins/kicad/sch_sexpr_plugin.h>
@@ -287,7 +293,8 @@ static void formatStroke( OUTPUTFORMATTER* aFormatter, int aNestLevel,
  */
 class SCH_SEXPR_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash; // Keep track of the modification status of the library.
+                                       // Atomic as libraries may be loaded concurrently.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -459,84 +466,192 @@ SCH_SHEET* SCH_SEXPR_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
 }
 
 
-// Everything below this comment is recursive.  Modify with care.
+/**
+ * A schematic file queued for parsing by SCH_SEXPR_PLUGIN::loadHierarchy().
+ *
+ * The job owns the parsed items until they are appended to the screen, so that they are
+ * freed whatever exception ends the load.
+ */
+struct SCH_SEXPR_SHEET_JOB
+{
+    SCH_SEXPR_SHEET_JOB( SCH_SHEET* aSheet, const wxString& aFileName ) :
+            m_sheet( aSheet ),
+            m_fileName( aFileName )
+    { }
+
+    SCH_SEXPR_SHEET_JOB( SCH_SEXPR_SHEET_JOB&& ) = default;
+    SCH_SEXPR_SHEET_JOB& operator=( SCH_SEXPR_SHEET_JOB&& ) = default;
+
+    ~SCH_SEXPR_SHEET_JOB()
+    {
+        for( SCH_ITEM* item : m_items )
+            delete item;
+    }
+
+    SCH_SHEET*             m_sheet;
+    wxString               m_fileName;
+    std::vector<SCH_ITEM*> m_items;     ///< Parsed items not yet appended to the screen.
+    std::vector<SCH_SEXPR_DEFERRED_IMAGE> m_images;     ///< Image data of the parsed bitmaps.
+    wxString               m_error;
+    std::exception_ptr     m_exception;
+};
+
 
 void SCH_SEXPR_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 {
-    SCH_SCREEN* screen = NULL;
+    if( aSheet->GetScreen() )
+        return;
 
-    if( !aSheet->GetScreen() )
-    {
-        // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object only
-        // stores the file name and extension.  Add the project path to the file name and
-        // extension to compare when calling SCH_SHEET::SearchHierarchy().
-        wxFileName fileName = aSheet->GetFileName();
+    // The hierarchy is loaded breadth first.  Each pass parses the files of every sheet
+    // discovered by the previous pass in parallel, then appends the parsed items to their
+    // screens and queues the child sheets on this thread.  Jobs are queued and linked in
+    // hierarchy order, so screen sharing and the resulting sheet tree do not depend on
+    // thread scheduling.
+    std::map<wxString, SCH_SCREEN*>  screens;     // Screens created by this load.
+    std::vector<SCH_SEXPR_SHEET_JOB> jobs;
+
+    auto queueSheet =
+            [&]( SCH_SHEET* aChild, const wxString& aParentPath )
+            {
+                // SCH_SCREEN objects store the full path and file name where the SCH_SHEET
+                // object only stores the file name and extension.  Sheet files are relative
+                // to the file of the sheet containing them.
+                wxFileName fileName = aChild->GetFileName();
+
+                if( !fileName.IsAbsolute() )
+                    fileName.MakeAbsolute( aParentPath );
+
+                wxString fullPath = fileName.GetFullPath();
+                SCH_SCREEN* screen = nullptr;
+
+                auto it = screens.find( fullPath );
+
+                if( it != screens.end() )
+                    screen = it->second;
+                else
+                    m_rootSheet->SearchHierarchy( fullPath, &screen );
+
+                if( screen )
+                {
+                    // Do not need to load the sub-sheets - this has already been done.
+                    aChild->SetScreen( screen );
+                    aChild->GetScreen()->SetParent( m_schematic );
+                    return;
+                }
+
+                wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fullPath );
 
-        if( !fileName.IsAbsolute() )
-            fileName.MakeAbsolute( m_currentPath.top() );
+                aChild->SetScreen( new SCH_SCREEN( m_schematic ) );
+                aChild->GetScreen()->SetFileName( fullPath );
+                screens[ fullPath ] = aChild->GetScreen();
+                jobs.emplace_back( aChild, fullPath );
+            };
 
-        // Save the current path so that it gets restored when decending and ascending the
-        // sheet hierarchy which allows for sheet schematic files to be nested in folders
-        // relative to the last path a schematic was loaded from.
-        wxLogTrace( traceSchLegacyPlugin, "Saving path    \"%s\"", m_currentPath.top() );
-        m_currentPath.push( fileName.GetPath() );
-        wxLogTrace( traceSchLegacyPlugin, "Current path   \"%s\"", m_currentPath.top() );
-        wxLogTrace( traceSchLegacyPlugin, "Loading        \"%s\"", fileName.GetFullPath() );
+    queueSheet( aSheet, m_currentPath.top() );
 
-        m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+    // Make sure the lazily translated default field names are cached before any worker
+    // thread creates a field.
+    TEMPLATE_FIELDNAME::GetDefaultFieldName( REFERENCE_FIELD );
+    SCH_SHEET::GetDefaultFieldName( SHEETNAME );
 
-        if( screen )
+    while( !jobs.empty() )
+    {
+        std::atomic<size_t> nextJob( 0 );
+
+        auto parseTask =
+                [&]() -> size_t
+                {
+                    for( size_t ii = nextJob++; ii < jobs.size(); ii = nextJob++ )
+                    {
+                        SCH_SEXPR_SHEET_JOB& job = jobs[ii];
+
+                        try
+                        {
+                            loadFile( job.m_fileName, job.m_sheet, &job.m_items, &job.m_images );
+                        }
+                        catch( const IO_ERROR& ioe )
+                        {
+                            job.m_error = ioe.What();
+                            job.m_exception = std::current_exception();
+                        }
+                    }
+
+                    return 1;
+                };
+
+        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                       jobs.size() );
+
+        if( parallelThreadCount <= 1 )
         {
-            aSheet->SetScreen( screen );
-            aSheet->GetScreen()->SetParent( m_schematic );
-            // Do not need to load the sub-sheets - this has already been done.
+            parseTask();
         }
         else
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-            try
-            {
-                loadFile( fileName.GetFullPath(), aSheet );
-            }
-            catch( const IO_ERROR& ioe )
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, parseTask );
+
+            // Finalize the threads.  Anything other than an IO_ERROR is rethrown here.
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii].get();
+        }
+
+        std::vector<SCH_SEXPR_SHEET_JOB> loaded;
+        loaded.swap( jobs );
+
+        for( SCH_SEXPR_SHEET_JOB& job : loaded )
+        {
+            SCH_SCREEN* screen = job.m_sheet->GetScreen();
+
+            if( job.m_exception )
             {
                 // If there is a problem loading the root sheet, there is no recovery.
-                if( aSheet == m_rootSheet )
-                    throw( ioe );
+                if( job.m_sheet == m_rootSheet )
+                    std::rethrow_exception( job.m_exception );
 
                 // For all subsheets, queue up the error message for the caller.
                 if( !m_error.IsEmpty() )
                     m_error += "\n";
 
-                m_error += ioe.What();
+                m_error += job.m_error;
             }
 
-            // This was moved out of the try{} block so that any sheets definitionsthat
-            // the plugin fully parsed before the exception was raised will be loaded.
-            for( auto aItem : aSheet->GetScreen()->Items().OfType( SCH_SHEET_T ) )
-            {
-                wxCHECK2( aItem->Type() == SCH_SHEET_T, /* do nothing */ );
-                auto sheet = static_cast<SCH_SHEET*>( aItem );
+            // Any items, including sheet definitions, that the parser fully parsed before an
+            // exception was raised are still loaded.  The screen owns them from here on.
+            for( const SCH_SEXPR_DEFERRED_IMAGE& image : job.m_images )
+                SCH_SEXPR_PARSER::SetImageData( image.m_Bitmap, image.m_Data );
+
+            std::vector<SCH_ITEM*> items;
+            items.swap( job.m_items );
 
-                // Recursion starts here.
-                loadHierarchy( sheet );
+            for( SCH_ITEM* item : items )
+                screen->Append( item );
+
+            screen->UpdateLocalLibSymbolLinks();
+
+            wxString path = wxFileName( job.m_fileName ).GetPath();
+
+            for( SCH_ITEM* item : items )
+            {
+                if( item->Type() == SCH_SHEET_T )
+                    queueSheet( static_cast<SCH_SHEET*>( item ), path );
             }
         }
-
-        m_currentPath.pop();
-        wxLogTrace( traceSchLegacyPlugin, "Restoring path \"%s\"", m_currentPath.top() );
     }
 }
 
 
-void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SHEET* aSheet )
+void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SHEET* aSheet,
+                                 std::vector<SCH_ITEM*>* aDeferredItems,
+                                 std::vector<SCH_SEXPR_DEFERRED_IMAGE>* aDeferredImages )
 {
     FILE_LINE_READER reader( aFileName );
 
     SCH_SEXPR_PARSER parser( &reader );
 
+    parser.SetDeferredItems( aDeferredItems, aDeferredImages );
     parser.ParseSchematic( aSheet );
 }
 
@@ -1302,7 +1417,7 @@ void SCH_SEXPR_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias, int aNes
 }
 
 
-int SCH_SEXPR_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_SEXPR_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
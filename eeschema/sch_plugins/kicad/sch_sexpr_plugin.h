@@ -32,7 +32,9 @@ class KIWAY;
 class LINE_READER;
 class SCH_SCREEN;
 class SCH_SHEET;
+class SCH_ITEM;
 class SCH_BITMAP;
+struct SCH_SEXPR_DEFERRED_IMAGE;
 class SCH_JUNCTION;
 class SCH_NO_CONNECT;
 class SCH_LINE;
@@ -129,7 +131,9 @@ public:
 
 private:
     void loadHierarchy( SCH_SHEET* aSheet );
-    void loadFile( const wxString& aFileName, SCH_SHEET* aSheet );
+    void loadFile( const wxString& aFileName, SCH_SHEET* aSheet,
+                   std::vector<SCH_ITEM*>* aDeferredItems = nullptr,
+                   std::vector<SCH_SEXPR_DEFERRED_IMAGE>* aDeferredImages = nullptr );
 
     void saveSymbol( SCH_COMPONENT* aComponent, SCH_SHEET_PATH* aSheetPath, int aNestLevel );
     void saveField( SCH_FIELD* aField, int aNestLevel );
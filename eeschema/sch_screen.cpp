@@ -51,6 +51,7 @@
 #include <sch_sheet.h>
 #include <sch_text.h>
 #include <schematic.h>
+#include <symbol_async_loader.h>
 #include <symbol_lib_table.h>
 #include <tool/common_tools.h>
 
@@ -1316,11 +1317,37 @@ void SCH_SCREENS::DeleteAllMarkers( enum MARKER_BASE::TYPEMARKER aMarkerType,
 
 void SCH_SCREENS::UpdateSymbolLinks( REPORTER* aReporter )
 {
+    SCH_SCREEN* first = GetFirst();
+
+    if( first && first->Schematic() )
+    {
+        // Pull the referenced libraries into their plugin caches concurrently, so linking
+        // the symbols below doesn't load them one at a time.  Load errors are reported when
+        // the symbols are linked.
+        SYMBOL_LIB_TABLE*     libs = first->Schematic()->Prj().SchSymbolLibTable();
+        wxArrayString         nicknames;
+        std::vector<wxString> toLoad;
+
+        GetLibNicknames( nicknames );
+
+        for( const wxString& nickname : nicknames )
+        {
+            if( libs->HasLibrary( nickname, true ) )
+                toLoad.push_back( nickname );
+        }
+
+        if( toLoad.size() > 1 )
+        {
+            SYMBOL_ASYNC_LOADER loader( toLoad, libs );
+
+            loader.Start();
+            loader.Join();
+        }
+    }
+
     for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
         screen->UpdateSymbolLinks( aReporter );
 
-    SCH_SCREEN* first = GetFirst();
-
     if( !first )
         return;
 
@@ -0,0 +1,159 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include <wx/translation.h>
+
+#include <lib_part.h>
+#include <locale_io.h>
+#include <symbol_async_loader.h>
+#include <symbol_lib_table.h>
+#include <template_fieldnames.h>
+#include <widgets/progress_reporter.h>
+
+
+SYMBOL_ASYNC_LOADER::SYMBOL_ASYNC_LOADER( const std::vector<wxString>& aNicknames,
+                                          SYMBOL_LIB_TABLE* aTable, bool aOnlyPowerSymbols,
+                                          LIB_PART_MAP* aOutput,
+                                          PROGRESS_REPORTER* aReporter ) :
+        m_table( aTable ),
+        m_nicknames( aNicknames ),
+        m_onlyPowerSymbols( aOnlyPowerSymbols ),
+        m_output( aOutput ),
+        m_reporter( aReporter ),
+        m_threadCount( 1 ),
+        m_nextLibrary( 0 ),
+        m_processed( 0 ),
+        m_threadsFinished( 0 ),
+        m_canceled( false )
+{
+    wxASSERT( m_table );
+
+    m_threadCount = std::max<size_t>( 1, std::min<size_t>( std::thread::hardware_concurrency(),
+                                                           MAX_THREADS ) );
+    m_threadCount = std::min( m_threadCount, std::max<size_t>( 1, m_nicknames.size() ) );
+}
+
+
+SYMBOL_ASYNC_LOADER::~SYMBOL_ASYNC_LOADER()
+{
+    // Don't leave workers running against a table which may be about to go away.
+    if( !m_returns.empty() )
+    {
+        Abort();
+        Join();
+    }
+}
+
+
+void SYMBOL_ASYNC_LOADER::Start()
+{
+    // The parsers switch to the C locale, which is GLOBAL.  It is only threadsafe to do so
+    // before the threads are created and to switch back after they have all finished.
+    m_locale = std::make_unique<LOCALE_IO>();
+
+    // Finding a row may lazily build the table index and instantiate the row's plugin, neither
+    // of which is threadsafe.  Do it up front so the workers only read the table.
+    for( const wxString& nickname : m_nicknames )
+        m_table->FindRow( nickname, true );
+
+    // Likewise for the lazily translated default field names used by every LIB_FIELD.
+    TEMPLATE_FIELDNAME::GetDefaultFieldName( REFERENCE_FIELD );
+
+    for( size_t ii = 0; ii < m_threadCount; ++ii )
+        m_returns.emplace_back( std::async( std::launch::async, &SYMBOL_ASYNC_LOADER::worker,
+                                            this ) );
+}
+
+
+bool SYMBOL_ASYNC_LOADER::Join()
+{
+    for( std::future<std::vector<LOADED_PAIR>>& ret : m_returns )
+    {
+        std::vector<LOADED_PAIR> results = ret.get();
+
+        if( m_output )
+        {
+            for( LOADED_PAIR& pair : results )
+                m_output->emplace( std::move( pair ) );
+        }
+    }
+
+    m_returns.clear();
+    m_locale.reset();
+
+    return m_errors.IsEmpty();
+}
+
+
+bool SYMBOL_ASYNC_LOADER::Done() const
+{
+    return m_threadsFinished.load() >= m_threadCount;
+}
+
+
+std::vector<SYMBOL_ASYNC_LOADER::LOADED_PAIR> SYMBOL_ASYNC_LOADER::worker()
+{
+    std::vector<LOADED_PAIR> ret;
+
+    for( size_t libraryIndex = m_nextLibrary++; libraryIndex < m_nicknames.size();
+         libraryIndex = m_nextLibrary++ )
+    {
+        if( m_canceled.load() )
+            break;
+
+        const wxString&        nickname = m_nicknames[libraryIndex];
+        std::vector<LIB_PART*> parts;
+
+        try
+        {
+            m_table->LoadSymbolLib( parts, nickname, m_onlyPowerSymbols );
+
+            if( m_output )
+                ret.emplace_back( nickname, std::move( parts ) );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxString msg = wxString::Format( _( "Error loading symbol library %s.\n\n%s\n" ),
+                                             nickname, ioe.What() );
+
+            std::lock_guard<std::mutex> lock( m_errorMutex );
+            m_errors += msg;
+        }
+        catch( const std::exception& se )
+        {
+            wxString msg = wxString::Format( _( "Error loading symbol library %s.\n\n%s\n" ),
+                                             nickname, se.what() );
+
+            std::lock_guard<std::mutex> lock( m_errorMutex );
+            m_errors += msg;
+        }
+
+        m_processed.fetch_add( 1 );
+
+        if( m_reporter )
+            m_reporter->AdvanceProgress();
+    }
+
+    m_threadsFinished.fetch_add( 1 );
+
+    return ret;
+}
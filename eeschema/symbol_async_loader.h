@@ -0,0 +1,117 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYMBOL_ASYNC_LOADER_H
+#define SYMBOL_ASYNC_LOADER_H
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <common.h>      // for std::hash<wxString>
+
+class LIB_PART;
+class LOCALE_IO;
+class PROGRESS_REPORTER;
+class SYMBOL_LIB_TABLE;
+
+
+/**
+ * Load a set of symbol libraries from a #SYMBOL_LIB_TABLE on worker threads.
+ *
+ * Each library row owns its own #SCH_PLUGIN and plugin cache, so distinct libraries can be
+ * loaded concurrently.  Construct one, call Start(), poll Done() (keeping the UI alive and
+ * calling Abort() on user cancellation), then call Join() to collect the results.
+ */
+class SYMBOL_ASYNC_LOADER
+{
+public:
+    typedef std::unordered_map<wxString, std::vector<LIB_PART*>> LIB_PART_MAP;
+
+    /**
+     * @param aNicknames is the list of libraries to load.
+     * @param aTable is the symbol library table to load the libraries from.
+     * @param aOnlyPowerSymbols if true, only power symbols will be returned in the output.
+     * @param aOutput if not null, receives the symbols of each library, keyed by nickname.
+     *                The libraries keep ownership of the symbols.
+     * @param aReporter if not null, is advanced once for each library loaded.
+     */
+    SYMBOL_ASYNC_LOADER( const std::vector<wxString>& aNicknames, SYMBOL_LIB_TABLE* aTable,
+                         bool aOnlyPowerSymbols = false, LIB_PART_MAP* aOutput = nullptr,
+                         PROGRESS_REPORTER* aReporter = nullptr );
+
+    ~SYMBOL_ASYNC_LOADER();
+
+    /**
+     * Spin up the worker threads.  Must be called from the main thread.
+     */
+    void Start();
+
+    /**
+     * Wait for the workers to finish and merge their results.  Must be called from the main
+     * thread, and before anything else uses the libraries being loaded.
+     *
+     * @return true if every library loaded without error.
+     */
+    bool Join();
+
+    /**
+     * Ask the workers to stop after the library they are currently loading.
+     */
+    void Abort() { m_canceled.store( true ); }
+
+    /// @return true once every library has been processed (or the load has been aborted).
+    bool Done() const;
+
+    /// @return the number of libraries processed so far.
+    size_t GetProcessedCount() const { return m_processed.load(); }
+
+    /// @return the error messages collected by Join(), one per library which failed.
+    const wxString& GetErrors() const { return m_errors; }
+
+    /// Upper bound on the number of worker threads.
+    static constexpr size_t MAX_THREADS = 8;
+
+private:
+    typedef std::pair<wxString, std::vector<LIB_PART*>> LOADED_PAIR;
+
+    std::vector<LOADED_PAIR> worker();
+
+    SYMBOL_LIB_TABLE*          m_table;
+    std::vector<wxString>      m_nicknames;
+    bool                       m_onlyPowerSymbols;
+    LIB_PART_MAP*              m_output;
+    PROGRESS_REPORTER*         m_reporter;
+
+    std::unique_ptr<LOCALE_IO> m_locale;
+    size_t                     m_threadCount;
+    std::atomic<size_t>        m_nextLibrary;
+    std::atomic<size_t>        m_processed;
+    std::atomic<size_t>        m_threadsFinished;
+    std::atomic_bool           m_canceled;
+    wxString                   m_errors;
+    std::mutex                 m_errorMutex;
+
+    std::vector<std::future<std::vector<LOADED_PAIR>>> m_returns;
+};
+
+#endif // SYMBOL_ASYNC_LOADER_H
@@ -24,6 +24,7 @@
 #include <widgets/app_progress_dialog.h>
 
 #include <eda_pattern_match.h>
+#include <symbol_async_loader.h>
 #include <symbol_lib_table.h>
 #include <lib_part.h>
 #include <generate_alias_info.h>
@@ -57,27 +58,51 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
                                               wxWindow* aParent )
 {
     APP_PROGRESS_DIALOG* prg = nullptr;
-    wxLongLong        nextUpdate = wxGetUTCTimeMillis() + (PROGRESS_INTERVAL_MILLIS / 2);
 
     if( m_show_progress )
     {
         prg = new APP_PROGRESS_DIALOG( _( "Loading Symbol Libraries" ), wxEmptyString,
-                                       aNicknames.size(), aParent );
+                                       aNicknames.size(), aParent, false,
+                                       wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_CAN_ABORT );
     }
 
-    unsigned int ii = 0;
+    // Load the libraries on worker threads; the tree itself must be populated from here.
+    SYMBOL_ASYNC_LOADER::LIB_PART_MAP loadedSymbols;
+    SYMBOL_ASYNC_LOADER               loader( aNicknames, m_libs,
+                                              GetFilter() == CMP_FILTER_POWER, &loadedSymbols );
 
-    for( const auto& nickname : aNicknames )
+    loader.Start();
+
+    while( !loader.Done() )
     {
-        if( prg && wxGetUTCTimeMillis() > nextUpdate )
+        if( prg )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+            size_t   count = loader.GetProcessedCount();
+            wxString msg = wxString::Format( _( "Loading symbol libraries (%d/%d)" ),
+                                             (int) count, (int) aNicknames.size() );
 
-            nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
+            if( !prg->Update( (int) count, msg ) )
+                loader.Abort();
         }
 
-        AddLibrary( nickname );
-        ii++;
+        wxMilliSleep( PROGRESS_INTERVAL_MILLIS / 2 );
+    }
+
+    loader.Join();
+
+    if( !loader.GetErrors().IsEmpty() )
+        wxLogError( wxT( "%s" ), loader.GetErrors() );
+
+    // Keep the order of the library table, not the order in which the libraries loaded.
+    for( const wxString& nickname : aNicknames )
+    {
+        auto it = loadedSymbols.find( nickname );
+
+        if( it != loadedSymbols.end() && !it->second.empty() )
+        {
+            std::vector<LIB_TREE_ITEM*> comp_list( it->second.begin(), it->second.end() );
+            DoAddLibrary( nickname, m_libs->GetDescription( nickname ), comp_list, false );
+        }
     }
 
     m_tree.AssignIntrinsicRanks();
@@ -111,6 +111,24 @@ public:
      */
     bool m_ShowRouterDebugGraphics;
 
+    /**
+     * Walk around obstacles in both directions on separate threads in the router.
+     * Ignored while the router debug graphics are shown.
+     */
+    bool m_RouterParallelWalkaround;
+
+    /**
+     * Optimize routed tracks once more after they are committed, as a separate undo step.
+     * The walkaround placer then skips merging segments while the mouse moves.
+     */
+    bool m_RouterDeferredOptimization;
+
+    /**
+     * Check the router world against a full sync each time it is updated incrementally.
+     * Differences are logged to the "PNS" trace and the world is then synced in full.
+     */
+    bool m_RouterCheckWorldSync;
+
     /**
      * Save files in compact display mode
      * When is is not specified, points are written one per line
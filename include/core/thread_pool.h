@@ -0,0 +1,93 @@
+/*
+* This program source code file is part of KiCad, a free EDA CAD application.
+*
+* Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the
+* Free Software Foundation, either version 3 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __KICAD_THREAD_POOL_H
+#define __KICAD_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * A fixed set of worker threads which run batches of indexed tasks.
+ *
+ * Unlike spawning std::async threads for every batch, the workers are started once and
+ * sleep between batches.  Tasks are handed out in index order through an atomic counter,
+ * so callers can put the most expensive tasks first.
+ */
+class THREAD_POOL
+{
+public:
+    /**
+     * @param aThreads is the number of worker threads.  The thread calling ParallelFor()
+     *                 also runs tasks, so zero workers runs everything on the caller.
+     */
+    THREAD_POOL( size_t aThreads );
+
+    ~THREAD_POOL();
+
+    /**
+     * Call \a aFunc for each index in [0, \a aCount) and return once all calls finished.
+     *
+     * Indices are claimed in increasing order.  Only one batch runs at a time; batches
+     * started from within a task run on the calling thread.
+     *
+     * If \a aFunc throws, no further index is started and the first exception is rethrown
+     * here once the running calls have finished.
+     */
+    void ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc );
+
+    /**
+     * Stop and join the worker threads.  Later batches run on the calling thread.
+     *
+     * The application pool must be shut down before static destruction: joining threads
+     * from there can deadlock on some platforms.  See PGM_BASE::Destroy().
+     */
+    void Shutdown();
+
+    size_t GetThreadCount() const { return m_threads.size(); }
+
+    /// @return the pool shared by the whole application, sized to the hardware.
+    static THREAD_POOL& GetInstance();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex               m_batchMutex;  ///< Serializes the batches.
+    std::mutex               m_mutex;       ///< Protects the batch state below.
+    std::condition_variable  m_wake;        ///< Signals the workers a new batch or exit.
+    std::condition_variable  m_done;        ///< Signals the caller the workers are idle.
+
+    const std::function<void( size_t )>* m_func;
+    size_t                               m_count;
+    std::atomic<size_t>                  m_next;
+    size_t                               m_generation;
+    size_t                               m_busy;
+    bool                                 m_quit;
+    std::exception_ptr                   m_exception;   ///< First exception of the batch.
+};
+
+#endif
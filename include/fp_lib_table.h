@@ -188,6 +188,21 @@ public:
      */
     const FOOTPRINT* GetEnumeratedFootprint( const wxString& aNickname,
                                              const wxString& aFootprintName );
+
+    /**
+     * Fetch the description, keywords and pad counts of a footprint without necessarily
+     * loading the whole footprint.
+     *
+     * @param aNickname is a locator for the "library", it is a "name" in #LIB_TABLE_ROW.
+     * @param aFootprintName is the name of the footprint.
+     * @param aMetadata is filled with the footprint metadata.
+     * @return true if the footprint was found, false otherwise.
+     *
+     * @throw IO_ERROR if the library cannot be found or read.
+     */
+    bool GetFootprintMetadata( const wxString& aNickname, const wxString& aFootprintName,
+                               FOOTPRINT_METADATA& aMetadata );
+
     /**
      * The set of return values from FootprintSave() below.
      */
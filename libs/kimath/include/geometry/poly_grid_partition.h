@@ -27,6 +27,7 @@
 
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <set>
 #include <unordered_map>
@@ -67,6 +68,20 @@ public:
         build( aPolyOutline, gridSize );
     }
 
+    /**
+     * Return a grid size for \a aPolyOutline which keeps the number of edges per cell low.
+     *
+     * Large zone fills have tens of thousands of vertices: with a fixed grid, every cell on
+     * the outline holds hundreds of edges and each point test scans all of them.
+     */
+    static int AdaptiveGridSize( const SHAPE_LINE_CHAIN& aPolyOutline, int aMinSize = 16,
+                                 int aMaxSize = 256 )
+    {
+        int size = (int) std::sqrt( (double) aPolyOutline.PointCount() );
+
+        return std::min( aMaxSize, std::max( aMinSize, size ) );
+    }
+
     int ContainsPoint( const VECTOR2I& aP, int aClearance = 0 )    // const
     {
         if( containsPoint(aP) )
@@ -111,7 +126,12 @@ private:
     {
         std::size_t operator()(  const SEG& a ) const
         {
-            return a.A.x + a.B.x + a.A.y + a.B.y;
+            // Must not depend on the direction of the segment (see segsEqual)
+            std::hash<int> hasher;
+            std::size_t    hA = hasher( a.A.x ) * 31 + hasher( a.A.y );
+            std::size_t    hB = hasher( a.B.x ) * 31 + hasher( a.B.y );
+
+            return ( hA ^ hB ) + ( hA * hB ) * 0x9e3779b9;
         }
     };
 
@@ -325,6 +345,9 @@ private:
         m_flags.reserve( m_outline.SegmentCount() );
 
         std::unordered_map<SEG, int, segHash, segsEqual> edgeSet;
+        std::vector<int>                                 indices;
+
+        edgeSet.reserve( m_outline.SegmentCount() );
 
         for( int i = 0; i<m_outline.SegmentCount(); i++ )
         {
@@ -369,10 +392,10 @@ private:
             if( edge.A.y == edge.B.y )
                 continue;
 
-            std::set<int> indices;
+            indices.clear();
 
-            indices.insert( m_gridSize * poly2gridY( edge.A.y ) + poly2gridX( edge.A.x ) );
-            indices.insert( m_gridSize * poly2gridY( edge.B.y ) + poly2gridX( edge.B.x ) );
+            indices.push_back( m_gridSize * poly2gridY( edge.A.y ) + poly2gridX( edge.A.x ) );
+            indices.push_back( m_gridSize * poly2gridY( edge.B.y ) + poly2gridX( edge.B.x ) );
 
             if( edge.A.x > edge.B.x )
                 std::swap( edge.A, edge.B );
@@ -390,9 +413,9 @@ private:
                     int py  = ( edge.A.y + rescale_trunc( dir.y, px - edge.A.x, dir.x ) );
                     int yy  = poly2gridY( py );
 
-                    indices.insert( m_gridSize * yy + x );
+                    indices.push_back( m_gridSize * yy + x );
  					if( x > 0 )
-                        indices.insert( m_gridSize * yy + x - 1 );
+                        indices.push_back( m_gridSize * yy + x - 1 );
 
                 }
             }
@@ -413,12 +436,15 @@ private:
                     int px  = ( edge.A.x + rescale_trunc( dir.x, py - edge.A.y, dir.y ) );
                     int xx  = poly2gridX( px );
 
-                    indices.insert( m_gridSize * y + xx );
+                    indices.push_back( m_gridSize * y + xx );
        				if( y > 0 )
-                        indices.insert( m_gridSize * (y - 1) + xx );
+                        indices.push_back( m_gridSize * (y - 1) + xx );
                 }
             }
 
+            std::sort( indices.begin(), indices.end() );
+            indices.erase( std::unique( indices.begin(), indices.end() ), indices.end() );
+
             for( auto idx : indices )
                 m_grid[idx].push_back( i );
         }
@@ -286,6 +286,32 @@ class SHAPE_INDEX
             return this->m_tree->Search( min, max, aVisitor );
         }
 
+        /**
+         * Runs a callback once on every SHAPE object in the vicinity of any of \a aBoxes,
+         * walking the tree a single time.
+         * @param aBoxes areas to search
+         * @param aMinDistance distance threshold
+         * @param aVisitor object to be invoked on every object found.
+         */
+        template <class V>
+        int Query( const std::vector<BOX2I>& aBoxes, int aMinDistance, V& aVisitor ) const
+        {
+            std::vector<typename RTree<T, int, 2, double>::Rect> rects( aBoxes.size() );
+
+            for( size_t i = 0; i < aBoxes.size(); i++ )
+            {
+                BOX2I box = aBoxes[i];
+                box.Inflate( aMinDistance );
+
+                rects[i].m_min[0] = box.GetX();
+                rects[i].m_min[1] = box.GetY();
+                rects[i].m_max[0] = box.GetRight();
+                rects[i].m_max[1] = box.GetBottom();
+            }
+
+            return this->m_tree->Search( rects, aVisitor );
+        }
+
         /**
          * Function Begin()
          *
@@ -418,6 +418,15 @@ public:
      */
     long long int Length() const;
 
+    /**
+     * Reserve room for \a aCount points, so that appending them does not reallocate.
+     */
+    void Reserve( size_t aCount )
+    {
+        m_points.reserve( aCount );
+        m_shapes.reserve( aCount );
+    }
+
     /**
      * Function Append()
      *
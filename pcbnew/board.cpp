@@ -65,6 +65,7 @@ BOARD::BOARD() :
         m_project( nullptr ),
         m_designSettings( new BOARD_DESIGN_SETTINGS( nullptr, "board.design_settings" ) ),
         m_NetInfo( this ),
+        m_unnotifiedChanges( 0 ),
         m_LegacyDesignSettingsLoaded( false ),
         m_LegacyCopperEdgeClearanceLoaded( false ),
         m_LegacyNetclassesLoaded( false )
@@ -101,6 +102,10 @@ BOARD::BOARD() :
 
 BOARD::~BOARD()
 {
+    // Listeners outliving the board must not try to unregister from it later
+    InvokeListeners( &BOARD_LISTENER::OnBoardDeleted, *this );
+    m_listeners.clear();
+
     // Clean up the owned elements
     DeleteMARKERs();
 
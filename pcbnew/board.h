@@ -164,6 +164,9 @@ public:
     virtual void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) { }
     virtual void OnBoardItemsChanged( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItem ) { }
     virtual void OnBoardHighlightNetChanged( BOARD& aBoard ) { }
+
+    /// The board is being deleted.  Listeners must not call it back from here.
+    virtual void OnBoardDeleted( BOARD& aBoard ) { }
 };
 
 
@@ -233,6 +236,8 @@ private:
 
     std::vector<BOARD_LISTENER*> m_listeners;
 
+    unsigned                     m_unnotifiedChanges;
+
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
     BOARD( const BOARD& aOther ) = delete;
@@ -1125,6 +1130,18 @@ public:
       */
     void OnItemsChanged( std::vector<BOARD_ITEM*>& aItems );
 
+    /**
+     * Record that items may have been changed without notifying the listeners, as scripts do
+     * when they edit items in place.
+     */
+    void OnUnnotifiedChanges() { m_unnotifiedChanges++; }
+
+    /**
+     * @return the number of calls to OnUnnotifiedChanges().  Listeners keeping copies of the
+     *         items start over when it differs from the value they last saw.
+     */
+    unsigned GetUnnotifiedChanges() const { return m_unnotifiedChanges; }
+
     /*
      * Consistency check of internal m_groups structure.
      * @param repair if true, modify groups structure until it passes the sanity check.
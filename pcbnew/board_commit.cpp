@@ -356,6 +356,8 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
         if( m_changes.size() > num_changes )
         {
+            std::vector<BOARD_ITEM*> netsChanged;
+
             for( size_t i = num_changes; i < m_changes.size(); ++i )
             {
                 COMMIT_LINE& ent = m_changes[i];
@@ -378,7 +380,11 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 }
 
                 view->Update( boardItem );
+                netsChanged.push_back( boardItem );
             }
+
+            // Listeners keeping copies of the items, like the router, need the new nets too
+            board->OnItemsChanged( netsChanged );
         }
     }
 
@@ -33,6 +33,9 @@
 #include <mutex>
 #include <algorithm>
 #include <future>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -42,6 +45,7 @@
 bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 {
     markItemNetAsDirty( aItem );
+    markClusterNetsAsDirty( aItem );
 
     switch( aItem->Type() )
     {
@@ -111,6 +115,40 @@ void CN_CONNECTIVITY_ALGO::markItemNetAsDirty( const BOARD_ITEM* aItem )
 }
 
 
+void CN_CONNECTIVITY_ALGO::markClusterNetsAsDirty( const BOARD_ITEM* aItem )
+{
+    auto markItems =
+            [this]( const BOARD_ITEM* aBoardItem )
+            {
+                auto it = m_itemMap.find( aBoardItem );
+
+                if( it == m_itemMap.end() )
+                    return;
+
+                for( CN_ITEM* item : it->second.m_items )
+                {
+                    // The cached ratsnest cluster holding the item must be rebuilt, and so
+                    // must the clusters of its neighbours: the item may have been the only
+                    // link between them.
+                    MarkNetAsDirty( item->ClusterNet() );
+
+                    for( CN_ITEM* connected : item->ConnectedItems() )
+                        MarkNetAsDirty( connected->Net() );
+                }
+            };
+
+    if( aItem->Type() == PCB_FOOTPRINT_T )
+    {
+        for( PAD* pad : static_cast<const FOOTPRINT*>( aItem )->Pads() )
+            markItems( pad );
+    }
+    else
+    {
+        markItems( aItem );
+    }
+}
+
+
 bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
 {
     if( !aItem->IsOnCopperLayer() )
@@ -286,17 +324,97 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 }
 
 
-const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode )
+static constexpr KICAD_T clusterTypes[] = { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T,
+                                            PCB_ZONE_T, PCB_FOOTPRINT_T, EOT };
+static constexpr KICAD_T propagateTypes[] = { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T,
+                                              PCB_FOOTPRINT_T, EOT };
+
+
+static bool isOfType( const CN_ITEM* aItem, const KICAD_T aTypes[] )
 {
-    constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_T,
-                                  PCB_FOOTPRINT_T, EOT };
-    constexpr KICAD_T no_zones[] = { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T,
-                                     PCB_FOOTPRINT_T, EOT };
+    for( int i = 0; aTypes[i] != EOT; i++ )
+    {
+        if( aItem->Parent()->Type() == aTypes[i] )
+            return true;
+    }
+
+    return false;
+}
+
 
+const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode )
+{
     if( aMode == CSM_PROPAGATE )
-        return SearchClusters( aMode, no_zones, -1 );
+        return SearchClusters( aMode, propagateTypes, -1 );
     else
-        return SearchClusters( aMode, types, -1 );
+        return SearchClusters( aMode, clusterTypes, -1 );
+}
+
+
+CN_CONNECTIVITY_ALGO::CLUSTERS
+CN_CONNECTIVITY_ALGO::searchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+                                      const std::vector<CN_ITEM*>& aSeeds )
+{
+    bool withinAnyNet = ( aMode != CSM_PROPAGATE );
+
+    std::unordered_set<CN_ITEM*> visited;
+    std::deque<CN_ITEM*>         Q;
+    CLUSTERS                     clusters;
+
+    for( CN_ITEM* root : aSeeds )
+    {
+        if( !root->Valid() || !isOfType( root, aTypes ) || visited.count( root ) )
+            continue;
+
+        if( withinAnyNet && root->Net() <= 0 )
+            continue;
+
+        CN_CLUSTER_PTR cluster = std::make_shared<CN_CLUSTER>();
+
+        visited.insert( root );
+        Q.clear();
+        Q.push_back( root );
+
+        while( Q.size() )
+        {
+            CN_ITEM* current = Q.front();
+
+            Q.pop_front();
+            cluster->Add( current );
+
+            for( CN_ITEM* n : current->ConnectedItems() )
+            {
+                if( withinAnyNet && n->Net() != root->Net() )
+                    continue;
+
+                if( n->Valid() && isOfType( n, aTypes ) && visited.insert( n ).second )
+                    Q.push_back( n );
+            }
+        }
+
+        clusters.push_back( cluster );
+    }
+
+    std::sort( clusters.begin(), clusters.end(),
+               []( const CN_CLUSTER_PTR& a, const CN_CLUSTER_PTR& b )
+               {
+                   return a->OriginNet() < b->OriginNet();
+               } );
+
+    return clusters;
+}
+
+
+void CN_CONNECTIVITY_ALGO::markChangedNets()
+{
+    for( CN_ITEM* item : m_itemList )
+    {
+        if( item->Valid() && item->Net() != item->ClusterNet() )
+        {
+            MarkNetAsDirty( item->Net() );
+            MarkNetAsDirty( item->ClusterNet() );
+        }
+    }
 }
 
 
@@ -306,16 +424,18 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 {
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
-    std::deque<CN_ITEM*> Q;
-    std::set<CN_ITEM*> item_set;
+    std::deque<CN_ITEM*>  Q;
+    std::vector<CN_ITEM*> item_list;
 
     CLUSTERS clusters;
 
     if( m_itemList.IsDirty() )
         searchConnections();
 
+    item_list.reserve( m_itemList.Size() );
+
     auto addToSearchList =
-            [&item_set, withinAnyNet, aSingleNet, aTypes]( CN_ITEM *aItem )
+            [&item_list, withinAnyNet, aSingleNet, aTypes]( CN_ITEM *aItem )
             {
                 if( withinAnyNet && aItem->Net() <= 0 )
                     return;
@@ -326,23 +446,12 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
                 if( aSingleNet >=0 && aItem->Net() != aSingleNet )
                     return;
 
-                bool found = false;
-
-                for( int i = 0; aTypes[i] != EOT; i++ )
-                {
-                    if( aItem->Parent()->Type() == aTypes[i] )
-                    {
-                        found = true;
-                        break;
-                    }
-                }
-
-                if( !found )
+                if( !isOfType( aItem, aTypes ) )
                     return;
 
                 aItem->SetVisited( false );
 
-                item_set.insert( aItem );
+                item_list.push_back( aItem );
             };
 
     std::for_each( m_itemList.begin(), m_itemList.end(), addToSearchList );
@@ -350,19 +459,13 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return CLUSTERS();
 
-    while( !item_set.empty() )
+    for( CN_ITEM* root : item_list )
     {
-        CN_CLUSTER_PTR cluster ( new CN_CLUSTER() );
-        CN_ITEM*       root;
-        auto           it = item_set.begin();
-
-        while( it != item_set.end() && (*it)->Visited() )
-            it = item_set.erase( item_set.begin() );
+        if( root->Visited() )
+            continue;
 
-        if( it == item_set.end() )
-            break;
+        CN_CLUSTER_PTR cluster = std::make_shared<CN_CLUSTER>();
 
-        root = *it;
         root->SetVisited( true );
 
         Q.clear();
@@ -529,9 +632,31 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
 }
 
 
-void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit )
+void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit, bool aDirtyNetsOnly )
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    if( !aDirtyNetsOnly )
+    {
+        m_connClusters = SearchClusters( CSM_PROPAGATE );
+        propagateConnections( aCommit );
+        return;
+    }
+
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    markChangedNets();
+
+    // A net can only be propagated differently if one of the items of its cluster was added,
+    // removed or changed, which left the net of that item dirty.
+    std::vector<CN_ITEM*> seeds;
+
+    for( CN_ITEM* item : m_itemList )
+    {
+        if( IsNetDirty( item->Net() ) )
+            seeds.push_back( item );
+    }
+
+    m_connClusters = searchClusters( CSM_PROPAGATE, propagateTypes, seeds );
     propagateConnections( aCommit );
 }
 
@@ -568,35 +693,48 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( ZONE* aZone, PCB_LAYER_ID
 
 void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones )
 {
-    for( auto& z : aZones )
+    std::unordered_map<const BOARD_ITEM*, CN_ZONE_ISOLATED_ISLAND_LIST*> zoneMap;
+
+    for( CN_ZONE_ISOLATED_ISLAND_LIST& z : aZones )
     {
         Remove( z.m_zone );
         Add( z.m_zone );
+
+        zoneMap[ z.m_zone ] = &z;
     }
 
-    m_connClusters = SearchClusters( CSM_CONNECTIVITY_CHECK );
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    // Only the clusters holding the refilled zones can contain islands, so search from their
+    // items rather than clustering the whole board.
+    std::vector<CN_ITEM*> seeds;
 
-    for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : aZones )
+    for( CN_ZONE_ISOLATED_ISLAND_LIST& z : aZones )
     {
-        for( PCB_LAYER_ID layer : zone.m_zone->GetLayerSet().Seq() )
+        for( CN_ITEM* item : ItemEntry( z.m_zone ).GetItems() )
+            seeds.push_back( item );
+    }
+
+    m_connClusters = searchClusters( CSM_CONNECTIVITY_CHECK, clusterTypes, seeds );
+
+    // Each cluster is visited once, instead of once per zone and layer
+    for( const CN_CLUSTER_PTR& cluster : m_connClusters )
+    {
+        if( !cluster->IsOrphaned() )
+            continue;
+
+        for( CN_ITEM* item : *cluster )
         {
-            if( zone.m_zone->GetFilledPolysList( layer ).IsEmpty() )
+            auto it = zoneMap.find( item->Parent() );
+
+            if( it == zoneMap.end() )
                 continue;
 
-            for( const CN_CLUSTER_PTR& cluster : m_connClusters )
-            {
-                if( cluster->Contains( zone.m_zone ) && cluster->IsOrphaned() )
-                {
-                    for( CN_ITEM* z : *cluster )
-                    {
-                        if( z->Parent() == zone.m_zone && z->Layer() == layer )
-                        {
-                            zone.m_islands[layer].push_back(
-                                    static_cast<CN_ZONE_LAYER*>( z )->SubpolyIndex() );
-                        }
-                    }
-                }
-            }
+            PCB_LAYER_ID layer = static_cast<PCB_LAYER_ID>( item->Layer() );
+
+            it->second->m_islands[layer].push_back(
+                    static_cast<CN_ZONE_LAYER*>( item )->SubpolyIndex() );
         }
     }
 }
@@ -604,7 +742,43 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLAT
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    markChangedNets();
+
+    // Ratsnest clusters never span more than one net, so the clusters of the clean nets are
+    // still valid and only the items of the dirty nets need to be searched again.
+    CLUSTERS              kept;
+    std::vector<CN_ITEM*> seeds;
+
+    for( const CN_CLUSTER_PTR& cluster : m_ratsnestClusters )
+    {
+        if( !IsNetDirty( cluster->OriginNet() ) )
+            kept.push_back( cluster );
+    }
+
+    for( CN_ITEM* item : m_itemList )
+    {
+        if( item->Valid() && IsNetDirty( item->Net() ) )
+        {
+            item->SetClusterNet( item->Net() );
+            seeds.push_back( item );
+        }
+    }
+
+    CLUSTERS rebuilt = searchClusters( CSM_RATSNEST, clusterTypes, seeds );
+
+    m_ratsnestClusters.clear();
+    m_ratsnestClusters.reserve( kept.size() + rebuilt.size() );
+
+    std::merge( kept.begin(), kept.end(), rebuilt.begin(), rebuilt.end(),
+                std::back_inserter( m_ratsnestClusters ),
+                []( const CN_CLUSTER_PTR& a, const CN_CLUSTER_PTR& b )
+                {
+                    return a->OriginNet() < b->OriginNet();
+                } );
+
     return m_ratsnestClusters;
 }
 
@@ -170,6 +170,27 @@ private:
 
     void    propagateConnections( BOARD_COMMIT* aCommit = nullptr );
 
+    /**
+     * Search the clusters containing \a aSeeds.  Unlike SearchClusters() the items outside
+     * of these clusters are not visited at all, so the cost depends only on the size of the
+     * clusters found.
+     */
+    CLUSTERS searchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+                             const std::vector<CN_ITEM*>& aSeeds );
+
+    /**
+     * Mark as dirty the nets of the items whose net code changed since the ratsnest clusters
+     * were last built (items can be renamed to another net without going through Remove()
+     * and Add()).
+     */
+    void markChangedNets();
+
+    /**
+     * Mark as dirty the nets of the clusters containing the items of \a aItem, before they
+     * are removed.
+     */
+    void markClusterNetsAsDirty( const BOARD_ITEM* aItem );
+
     template <class Container, class BItem>
     void add( Container& c, BItem brditem )
     {
@@ -196,7 +217,7 @@ public:
 
     bool IsNetDirty( int aNet ) const
     {
-        if( aNet < 0 )
+        if( aNet < 0 || aNet >= (int) m_dirtyNets.size() )
             return false;
 
         return m_dirtyNets[ aNet ];
@@ -239,8 +260,9 @@ public:
     /**
      * Propagates nets from pads to other items in clusters
      * @param aCommit is used to store undo information for items modified by the call
+     * @param aDirtyNetsOnly restricts the search to the clusters containing items of dirty nets
      */
-    void PropagateNets( BOARD_COMMIT* aCommit = nullptr );
+    void PropagateNets( BOARD_COMMIT* aCommit = nullptr, bool aDirtyNetsOnly = false );
 
     void FindIsolatedCopperIslands( ZONE* aZone, PCB_LAYER_ID aLayer, std::vector<int>& aIslands );
 
@@ -252,6 +274,12 @@ public:
      */
     void FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones );
 
+    /**
+     * Return the ratsnest clusters of all nets.
+     *
+     * The clusters are cached between calls: only the clusters of dirty nets are searched
+     * again, so the cost of an update is proportional to the size of the nets it touched.
+     */
     const CLUSTERS& GetClusters();
 
     const CN_LIST& ItemList() const
@@ -34,6 +34,7 @@
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <connectivity/from_to_cache.h>
+#include <core/thread_pool.h>
 
 #include <ratsnest/ratsnest_data.h>
 
@@ -62,6 +63,9 @@ CONNECTIVITY_DATA::~CONNECTIVITY_DATA()
 
 bool CONNECTIVITY_DATA::Add( BOARD_ITEM* aItem )
 {
+    // The dynamic ratsnest worker reads the board connectivity.
+    WaitForDynamicRatsnest();
+
     m_connAlgo->Add( aItem );
     return true;
 }
@@ -69,6 +73,8 @@ bool CONNECTIVITY_DATA::Add( BOARD_ITEM* aItem )
 
 bool CONNECTIVITY_DATA::Remove( BOARD_ITEM* aItem )
 {
+    WaitForDynamicRatsnest();
+
     m_connAlgo->Remove( aItem );
     return true;
 }
@@ -76,6 +82,8 @@ bool CONNECTIVITY_DATA::Remove( BOARD_ITEM* aItem )
 
 bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 {
+    WaitForDynamicRatsnest();
+
     m_connAlgo->Remove( aItem );
     m_connAlgo->Add( aItem );
     return true;
@@ -84,9 +92,13 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 
 void CONNECTIVITY_DATA::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 {
+    WaitForDynamicRatsnest();
+
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aBoard, aReporter );
 
+    m_fromToCache->Clear();
+
     m_netclassMap.clear();
 
     for( NETINFO_ITEM* net : aBoard->GetNetInfo() )
@@ -99,6 +111,8 @@ void CONNECTIVITY_DATA::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 
 void CONNECTIVITY_DATA::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    WaitForDynamicRatsnest();
+
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aItems );
 
@@ -127,32 +141,19 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( dirty_nets.size() + 7 ) / 8 );
-
-    std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
-    {
-        for( size_t i = nextNet++; i < dirty_nets.size(); i = nextNet++ )
-            dirty_nets[i]->Update();
-
-        return 1;
-    };
-
-    if( parallelThreadCount == 1 )
-        update_lambda();
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+    // Hand out the largest nets first, so that a huge net (e.g. GND) starts right away
+    // instead of being picked up last and leaving the other threads idle
+    std::stable_sort( dirty_nets.begin(), dirty_nets.end(),
+                      []( RN_NET* aA, RN_NET* aB )
+                      {
+                          return aA->GetNodeCount() > aB->GetNodeCount();
+                      } );
 
-        // Finalize the ratsnest threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+    THREAD_POOL::GetInstance().ParallelFor( dirty_nets.size(),
+                                            [&dirty_nets]( size_t aIdx )
+                                            {
+                                                dirty_nets[aIdx]->Update();
+                                            } );
 
     #ifdef PROFILE
     rnUpdate.Show();
@@ -170,7 +171,10 @@ void CONNECTIVITY_DATA::addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& a
 
 void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 {
-    m_connAlgo->PropagateNets( aCommit );
+    // The dynamic ratsnest worker reads the ratsnest nets
+    WaitForDynamicRatsnest();
+
+    m_connAlgo->PropagateNets( aCommit, true );
 
     int lastNet = m_connAlgo->NetCount();
 
@@ -185,21 +189,30 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 
     auto clusters = m_connAlgo->GetClusters();
 
-    int dirtyNets = 0;
+    std::vector<int> dirtyNets;
 
     for( int net = 0; net < lastNet; net++ )
     {
         if( m_connAlgo->IsNetDirty( net ) )
         {
             m_nets[net]->Clear();
-            dirtyNets++;
+            dirtyNets.push_back( net );
         }
     }
 
+    // The constructor building from a list of items runs before the cache exists
+    if( m_fromToCache )
+        m_fromToCache->InvalidateNets( dirtyNets );
+
+    std::vector<std::shared_ptr<CN_CLUSTER>> dirtyClusters;
+
     for( const auto& c : clusters )
     {
         int net = c->OriginNet();
 
+        if( m_connAlgo->IsNetDirty( net ) )
+            dirtyClusters.push_back( c );
+
         // Don't add intentionally-kept zone islands to the ratsnest
         if( c->IsOrphaned() && c->Size() == 1 )
         {
@@ -216,12 +229,87 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
     m_connAlgo->ClearDirtyFlags();
 
     if( !m_skipRatsnest )
+    {
         updateRatsnest();
+        updateNetStats( dirtyNets, dirtyClusters );
+    }
+}
+
+
+void CONNECTIVITY_DATA::updateNetStats( const std::vector<int>& aNets,
+                                        const std::vector<std::shared_ptr<CN_CLUSTER>>& aClusters )
+{
+    if( m_netStats.size() < m_nets.size() )
+        m_netStats.resize( m_nets.size() );
+
+    for( int net : aNets )
+        m_netStats[net] = CN_NET_STATS();
+
+    // Ratsnest clusters never span more than one net, and every item of a net is in one of
+    // them, so the clusters of the dirty nets hold exactly their items.
+    for( const std::shared_ptr<CN_CLUSTER>& cluster : aClusters )
+    {
+        int net = cluster->OriginNet();
+
+        if( net < 0 || net >= (int) m_netStats.size() )
+            continue;
+
+        CN_NET_STATS& stats = m_netStats[net];
+
+        for( CN_ITEM* item : *cluster )
+        {
+            if( !item->Valid() )
+                continue;
+
+            BOARD_CONNECTED_ITEM* parent = item->Parent();
+
+            switch( parent->Type() )
+            {
+            case PCB_PAD_T:
+                stats.m_PadCount++;
+                stats.m_PadToDieLength += static_cast<PAD*>( parent )->GetPadToDieLength();
+                break;
+
+            case PCB_VIA_T:
+            {
+                VIA* via = static_cast<VIA*>( parent );
+
+                stats.m_ViaCount++;
+                stats.m_ViaSpans[ std::make_pair( via->TopLayer(), via->BottomLayer() ) ]++;
+                break;
+            }
+
+            case PCB_TRACE_T:
+            case PCB_ARC_T:
+                stats.m_RoutedLength += static_cast<TRACK*>( parent )->GetLength();
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+
+    for( int net : aNets )
+        m_netStats[net].m_UnconnectedCount = m_nets[net]->GetUnconnected().size();
+}
+
+
+const CN_NET_STATS& CONNECTIVITY_DATA::GetNetStats( int aNet ) const
+{
+    static const CN_NET_STATS empty;
+
+    if( aNet < 0 || aNet >= (int) m_netStats.size() )
+        return empty;
+
+    return m_netStats[aNet];
 }
 
 
 void CONNECTIVITY_DATA::BlockRatsnestItems( const std::vector<BOARD_ITEM*>& aItems )
 {
+    WaitForDynamicRatsnest();
+
     std::vector<BOARD_CONNECTED_ITEM*> citems;
 
     for( auto item : aItems )
@@ -274,17 +362,12 @@ void CONNECTIVITY_DATA::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_
 }
 
 
-void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems,
-                                                const CONNECTIVITY_DATA* aDynamicData )
+void CONNECTIVITY_DATA::addDynamicBoardLines( const CONNECTIVITY_DATA* aDynamicData,
+                                              std::vector<RN_DYNAMIC_LINE>& aLines ) const
 {
-    if( !aDynamicData )
-        return;
-
-    m_dynamicRatsnest.clear();
-
     // This gets connections between the stationary board and the
     // moving selection
-    for( unsigned int nc = 1; nc < aDynamicData->m_nets.size(); nc++ )
+    for( unsigned int nc = 1; nc < aDynamicData->m_nets.size() && nc < m_nets.size(); nc++ )
     {
         auto dynNet = aDynamicData->m_nets[nc];
 
@@ -300,11 +383,16 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
                 l.b = nodeB->Pos();
                 l.netCode = nc;
 
-                m_dynamicRatsnest.push_back( l );
+                aLines.push_back( l );
             }
         }
     }
+}
+
 
+void CONNECTIVITY_DATA::addDynamicInternalLines( const std::vector<BOARD_ITEM*>& aItems,
+                                                 std::vector<RN_DYNAMIC_LINE>& aLines )
+{
     // This gets the ratsnest for internal connections in the moving set
     const auto& edges = GetRatsnestForItems( aItems );
 
@@ -318,13 +406,122 @@ void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>&
         l.a = nodeA->Parent()->GetPosition();
         l.b = nodeB->Parent()->GetPosition();
         l.netCode = 0;
-        m_dynamicRatsnest.push_back( l );
+        aLines.push_back( l );
+    }
+}
+
+
+void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems,
+                                                const CONNECTIVITY_DATA* aDynamicData )
+{
+    if( !aDynamicData )
+        return;
+
+    WaitForDynamicRatsnest();
+
+    m_dynamicRatsnest.clear();
+
+    addDynamicBoardLines( aDynamicData, m_dynamicRatsnest );
+    addDynamicInternalLines( aItems, m_dynamicRatsnest );
+}
+
+
+void CONNECTIVITY_DATA::ComputeDynamicRatsnestAsync(
+        const std::vector<BOARD_ITEM*>& aItems,
+        const std::shared_ptr<CONNECTIVITY_DATA>& aDynamicData, const VECTOR2I& aDelta,
+        std::function<void()> aOnUpdate )
+{
+    if( !aDynamicData )
+        return;
+
+    if( aDynamicData != m_dynamicData )
+    {
+        // A new set of moving items.  The lines between the items themselves only depend on
+        // the board, so they are computed here once and just follow the items afterwards.
+        WaitForDynamicRatsnest();
+
+        m_dynamicData = aDynamicData;
+        m_dynamicOffset = VECTOR2I( 0, 0 );
+        m_dynamicInternalLines.clear();
+        addDynamicInternalLines( aItems, m_dynamicInternalLines );
+    }
+
+    std::lock_guard<std::mutex> lock( m_dynamicMutex );
+
+    m_dynamicPendingDelta += aDelta;
+    m_dynamicRequested = true;
+    m_dynamicOnUpdate = std::move( aOnUpdate );
+
+    if( !m_dynamicRunning )
+    {
+        m_dynamicRunning = true;
+        m_dynamicWorker = std::async( std::launch::async, [this]()
+                                                          {
+                                                              dynamicRatsnestWorker();
+                                                          } );
     }
 }
 
 
+void CONNECTIVITY_DATA::dynamicRatsnestWorker()
+{
+    while( true )
+    {
+        VECTOR2I              delta;
+        std::function<void()> onUpdate;
+
+        {
+            std::lock_guard<std::mutex> lock( m_dynamicMutex );
+
+            if( !m_dynamicRequested )
+            {
+                m_dynamicRunning = false;
+                return;
+            }
+
+            delta = m_dynamicPendingDelta;
+            onUpdate = m_dynamicOnUpdate;
+            m_dynamicPendingDelta = VECTOR2I( 0, 0 );
+            m_dynamicRequested = false;
+        }
+
+        m_dynamicData->Move( delta );
+        m_dynamicOffset += delta;
+
+        std::vector<RN_DYNAMIC_LINE> lines;
+
+        addDynamicBoardLines( m_dynamicData.get(), lines );
+
+        for( RN_DYNAMIC_LINE line : m_dynamicInternalLines )
+        {
+            line.a += m_dynamicOffset;
+            line.b += m_dynamicOffset;
+            lines.push_back( line );
+        }
+
+        {
+            std::lock_guard<KISPINLOCK> lock( m_lock );
+            m_dynamicRatsnest.swap( lines );
+        }
+
+        if( onUpdate )
+            onUpdate();
+    }
+}
+
+
+void CONNECTIVITY_DATA::WaitForDynamicRatsnest()
+{
+    if( m_dynamicWorker.valid() )
+        m_dynamicWorker.get();
+}
+
+
 void CONNECTIVITY_DATA::ClearDynamicRatsnest()
 {
+    WaitForDynamicRatsnest();
+    m_dynamicData.reset();
+
     m_connAlgo->ForEachAnchor( []( CN_ANCHOR& anchor )
                                {
                                    anchor.SetNoLine( false );
@@ -335,6 +532,9 @@ void CONNECTIVITY_DATA::ClearDynamicRatsnest()
 
 void CONNECTIVITY_DATA::HideDynamicRatsnest()
 {
+    WaitForDynamicRatsnest();
+
+    std::lock_guard<KISPINLOCK> lock( m_lock );
     m_dynamicRatsnest.clear();
 }
 
@@ -398,10 +598,13 @@ unsigned int CONNECTIVITY_DATA::GetUnconnectedCount() const
 
 void CONNECTIVITY_DATA::Clear()
 {
+    WaitForDynamicRatsnest();
+
     for( auto net : m_nets )
         delete net;
 
     m_nets.clear();
+    m_netStats.clear();
 }
 
 
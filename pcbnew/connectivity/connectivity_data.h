@@ -30,6 +30,9 @@
 #include <core/typeinfo.h>
 #include <core/spinlock.h>
 
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -62,6 +65,23 @@ struct CN_DISJOINT_NET_ENTRY
     VECTOR2I anchorA, anchorB;
 };
 
+/**
+ * Aggregated values of one net, refreshed by CONNECTIVITY_DATA::RecalculateRatsnest() for the
+ * nets which changed.
+ */
+struct CN_NET_STATS
+{
+    unsigned int m_PadCount = 0;
+    unsigned int m_ViaCount = 0;
+    unsigned int m_UnconnectedCount = 0;   ///< Ratsnest edges left to route
+    long long    m_RoutedLength = 0;       ///< Total length of the tracks and arcs
+    long long    m_PadToDieLength = 0;     ///< Total pad to die length of the pads
+
+    ///< Number of vias of each (top layer, bottom layer) span, so that via lengths can be
+    ///< derived from the current board stackup
+    std::map<std::pair<PCB_LAYER_ID, PCB_LAYER_ID>, unsigned int> m_ViaSpans;
+};
+
 /**
  * A structure used for calculating isolated islands on a given zone across all its layers
  */
@@ -190,6 +210,12 @@ public:
 
     unsigned int GetPadCount( int aNet = -1 ) const;
 
+    /**
+     * Return the aggregated values of net \a aNet, as of the last RecalculateRatsnest() call.
+     * This does not walk the items of the board.
+     */
+    const CN_NET_STATS& GetNetStats( int aNet ) const;
+
     const std::vector<TRACK*> GetConnectedTracks( const BOARD_CONNECTED_ITEM* aItem ) const;
 
     const std::vector<PAD*> GetConnectedPads( const BOARD_CONNECTED_ITEM* aItem ) const;
@@ -232,6 +258,27 @@ public:
     void ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems,
                                  const CONNECTIVITY_DATA* aDynamicData );
 
+#ifndef SWIG
+    /**
+     * Calculate the dynamic ratsnest like ComputeDynamicRatsnest(), but on a worker thread so
+     * that interactive moves are never blocked by it.
+     *
+     * \a aDynamicData is moved by \a aDelta on the worker before the lines are computed.
+     * Requests made while the worker is busy are coalesced: their deltas are added up and
+     * only the latest position is computed.
+     *
+     * @param aOnUpdate is called from the worker thread each time new lines are available.
+     */
+    void ComputeDynamicRatsnestAsync( const std::vector<BOARD_ITEM*>& aItems,
+                                      const std::shared_ptr<CONNECTIVITY_DATA>& aDynamicData,
+                                      const VECTOR2I& aDelta, std::function<void()> aOnUpdate );
+#endif
+
+    /**
+     * Wait for the asynchronous dynamic ratsnest computation, if any, to finish.
+     */
+    void WaitForDynamicRatsnest();
+
     const std::vector<RN_DYNAMIC_LINE>& GetDynamicRatsnest() const
     {
         return m_dynamicRatsnest;
@@ -291,6 +338,13 @@ private:
 
     void    updateRatsnest();
 
+    /**
+     * Recompute the statistics of \a aNets from \a aClusters, their rebuilt ratsnest clusters.
+     * The statistics of the other nets are kept.
+     */
+    void    updateNetStats( const std::vector<int>& aNets,
+                            const std::vector<std::shared_ptr<CN_CLUSTER>>& aClusters );
+
     /**
      * Updates the item positions without modifying the dirtyNet flag.  This is valid only when the
      * item list contains all elements in the connectivity database
@@ -299,10 +353,33 @@ private:
     void    updateItemPositions( const std::vector<BOARD_ITEM*>& aItems );
     void    addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& aCluster );
 
+    ///< Add the dynamic ratsnest lines between the board and the moving items of aDynamicData.
+    void    addDynamicBoardLines( const CONNECTIVITY_DATA* aDynamicData,
+                                  std::vector<RN_DYNAMIC_LINE>& aLines ) const;
+
+    ///< Add the dynamic ratsnest lines between the moving items aItems themselves.
+    void    addDynamicInternalLines( const std::vector<BOARD_ITEM*>& aItems,
+                                     std::vector<RN_DYNAMIC_LINE>& aLines );
+
+    void    dynamicRatsnestWorker();
+
     std::shared_ptr<CN_CONNECTIVITY_ALGO> m_connAlgo;
     std::shared_ptr<FROM_TO_CACHE> m_fromToCache;
     std::vector<RN_DYNAMIC_LINE> m_dynamicRatsnest;
+
+    ///< State of the asynchronous dynamic ratsnest computation.  The pending request is
+    ///< protected by m_dynamicMutex; the rest is only changed while no worker is running.
+    std::mutex                         m_dynamicMutex;
+    std::future<void>                  m_dynamicWorker;
+    bool                               m_dynamicRunning = false;
+    bool                               m_dynamicRequested = false;
+    VECTOR2I                           m_dynamicPendingDelta;
+    std::function<void()>              m_dynamicOnUpdate;
+    std::shared_ptr<CONNECTIVITY_DATA> m_dynamicData;
+    std::vector<RN_DYNAMIC_LINE>       m_dynamicInternalLines;   ///< at m_dynamicData creation
+    VECTOR2I                           m_dynamicOffset;          ///< move since creation
     std::vector<RN_NET*> m_nets;
+    std::vector<CN_NET_STATS> m_netStats;
 
     PROGRESS_REPORTER* m_progressReporter;
 
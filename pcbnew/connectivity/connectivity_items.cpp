@@ -186,6 +186,23 @@ const VECTOR2I CN_ZONE_LAYER::GetAnchor( int n ) const
 }
 
 
+void CN_ITEM::AddAnchors( const std::vector<VECTOR2I>& aPositions )
+{
+    auto pool = std::make_shared<std::vector<CN_ANCHOR>>();
+
+    pool->reserve( aPositions.size() );
+
+    for( const VECTOR2I& pos : aPositions )
+        pool->emplace_back( pos, this );
+
+    m_anchors.reserve( m_anchors.size() + pool->size() );
+
+    // Each anchor pointer shares the ownership of the whole pool
+    for( CN_ANCHOR& anchor : *pool )
+        m_anchors.emplace_back( pool, &anchor );
+}
+
+
 void CN_ITEM::RemoveInvalidRefs()
 {
     for( auto it = m_connected.begin(); it != m_connected.end(); )
@@ -283,8 +300,7 @@ CN_ITEM* CN_LIST::Add( ARC* aArc )
          CN_ZONE_LAYER* zitem = new CN_ZONE_LAYER( zone, aLayer, false, j );
          const auto& outline = zone->GetFilledPolysList( aLayer ).COutline( j );
 
-         for( int k = 0; k < outline.PointCount(); k++ )
-             zitem->AddAnchor( outline.CPoint( k ) );
+         zitem->AddAnchors( outline.CPoints() );
 
          m_items.push_back( zitem );
          zitem->SetLayer( aLayer );
@@ -115,7 +115,7 @@ public:
         return m_noline;
     }
 
-    inline void SetCluster( std::shared_ptr<CN_CLUSTER> aCluster )
+    inline void SetCluster( const std::shared_ptr<CN_CLUSTER>& aCluster )
     {
         m_cluster = aCluster;
     }
@@ -179,7 +179,8 @@ public:
         m_visited = false;
         m_valid = true;
         m_dirty = true;
-        m_anchors.reserve( std::max( 6, aAnchorCount ) );
+        m_clusterNet = -1;
+        m_anchors.reserve( aAnchorCount );
         m_layers = LAYER_RANGE( 0, PCB_LAYER_ID_COUNT );
         m_connected.reserve( 8 );
     }
@@ -191,6 +192,15 @@ public:
         m_anchors.emplace_back( std::make_shared<CN_ANCHOR>( aPos, this ) );
     }
 
+    /**
+     * Add anchors at \a aPositions.  The anchors are stored contiguously in a single
+     * allocation, which lives as long as any of them is referenced.
+     *
+     * This only pays off for items with many anchors, such as zone outlines.  Building the
+     * position list costs more than it saves for items with one or two anchors.
+     */
+    void AddAnchors( const std::vector<VECTOR2I>& aPositions );
+
     CN_ANCHORS& Anchors() { return m_anchors; }
 
     void SetValid( bool aValid ) { m_valid = aValid; }
@@ -252,6 +262,10 @@ public:
     void SetVisited( bool aVisited ) { m_visited = aVisited; }
     bool Visited() const { return m_visited; }
 
+    ///< Net the item belonged to when the ratsnest clusters were last built, or -1.
+    void SetClusterNet( int aNet ) { m_clusterNet = aNet; }
+    int ClusterNet() const { return m_clusterNet; }
+
     bool CanChangeNet() const { return m_canChangeNet; }
 
     void Connect( CN_ITEM* b )
@@ -292,6 +306,7 @@ private:
 
     bool            m_visited;       ///< visited flag for the BFS scan
     bool            m_valid;         ///< used to identify garbage items (we use lazy removal)
+    int             m_clusterNet;    ///< net of the item in the cached ratsnest clusters
 
     std::mutex      m_listLock;      ///< mutex protecting this item's connected_items set to
 };
@@ -311,7 +326,8 @@ public:
         outline.SetClosed( true );
         outline.Simplify();
 
-        m_cachedPoly = std::make_unique<POLY_GRID_PARTITION>( outline, 16 );
+        m_cachedPoly = std::make_unique<POLY_GRID_PARTITION>(
+                outline, POLY_GRID_PARTITION::AdaptiveGridSize( outline ) );
     }
 
     int SubpolyIndex() const
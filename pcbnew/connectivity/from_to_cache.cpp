@@ -17,8 +17,12 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <future>
 #include <memory>
+#include <thread>
 #include <reporter.h>
 #include <board.h>
 #include <track.h>
@@ -188,34 +192,74 @@ int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo
         }
     }
 
-    int newPaths = 0;
+    FT_QUERY& query = m_ftQueries[ std::make_pair( aFrom, aTo ) ];
 
-    for( auto &path : paths )
+    for( const FT_PATH& path : paths )
+        query.nets.insert( path.net );
+
+    // Look up the connectivity items first: ItemEntry() is not safe to call concurrently
+    std::vector<std::pair<CN_ITEM*, CN_ITEM*>> ends( paths.size(), { nullptr, nullptr } );
+
+    for( size_t i = 0; i < paths.size(); i++ )
     {
-        if( !path.from || !path.to )
+        if( !paths[i].from || !paths[i].to )
             continue;
 
+        ends[i].first = cnAlgo->ItemEntry( paths[i].from ).GetItems().front();
+        ends[i].second = cnAlgo->ItemEntry( paths[i].to ).GetItems().front();
+    }
 
-        CN_ITEM *cnFrom = cnAlgo->ItemEntry( path.from ).GetItems().front();
-        CN_ITEM *cnTo = cnAlgo->ItemEntry( path.to ).GetItems().front();
-        CN_ITEM::CONNECTED_ITEMS upath;
+    std::vector<PATH_STATUS>              results( paths.size(), PS_NO_PATH );
+    std::vector<CN_ITEM::CONNECTED_ITEMS> upaths( paths.size() );
 
-        auto result = uniquePathBetweenNodes( cnFrom, cnTo, upath );
+    // The path searches only read the connectivity graph, so they run in parallel.
+    // We don't want to spin up a new thread for fewer than 4 searches (overhead costs)
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+            ( paths.size() + 3 ) / 4 );
 
-        if( result == PS_OK )
-            path.isUnique = true;
-        else
-            path.isUnique = false;
+    std::atomic<size_t> nextPath( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto search_lambda = [&nextPath, &ends, &results, &upaths]() -> size_t
+    {
+        for( size_t i = nextPath++; i < ends.size(); i = nextPath++ )
+        {
+            if( ends[i].first && ends[i].second )
+                results[i] = uniquePathBetweenNodes( ends[i].first, ends[i].second, upaths[i] );
+        }
+
+        return 1;
+    };
+
+    if( parallelThreadCount <= 1 )
+        search_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, search_lambda );
 
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    int newPaths = 0;
+
+    for( size_t i = 0; i < paths.size(); i++ )
+    {
+        FT_PATH& path = paths[i];
+
+        if( !path.from || !path.to )
+            continue;
 
-        //printf( "%s\n", (const char *) wxString::Format( _("Check path: %s -> %s (net %s)"), path.fromName, path.toName, cnFrom->Parent()->GetNetname() ) );
+        path.isUnique = ( results[i] == PS_OK );
 
-        if( result == PS_NO_PATH )
+        if( results[i] == PS_NO_PATH )
             continue;
 
-        for( auto item : upath )
+        for( auto item : upaths[i] )
         {
             path.pathItems.insert( item->Parent() );
+            query.items.insert( item->Parent() );
         }
 
         m_ftPaths.push_back(path);
@@ -227,47 +271,76 @@ int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo
     return newPaths;
 }
 
-bool  FROM_TO_CACHE::IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom, const wxString& aTo )
+bool FROM_TO_CACHE::IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom,
+                                    const wxString& aTo )
 {
-    int nFromTosFound = 0;
-
     if( !m_board )
         return false;
 
-    //printf("Check %d cached paths [%p]\n", m_ftPaths.size(), aItem );
-    for( int attempt = 0; attempt < 2; attempt++ )
-    {
-        // item already belongs to path
-        for( auto& ftPath : m_ftPaths )
-        {
-            if( aFrom == ftPath.fromWildcard &&
-                    aTo == ftPath.toWildcard )
-                {
-                    nFromTosFound++;
+    auto it = m_ftQueries.find( std::make_pair( aFrom, aTo ) );
 
-                    if( ftPath.pathItems.count( aItem ) )
-                    {
-            //            printf("Found cached path for %p [%s->%s]\n", aItem, (const char *)ftPath.fromName, (const char *) ftPath.toName );
-                        return true;
-                    }
-                }
-        }
-
-        if( !nFromTosFound )
-            cacheFromToPaths( aFrom, aTo );
-        else
-            return false;
+    if( it == m_ftQueries.end() )
+    {
+        cacheFromToPaths( aFrom, aTo );
+        it = m_ftQueries.find( std::make_pair( aFrom, aTo ) );
     }
 
-    return false;
+    return it->second.items.count( aItem ) > 0;
 }
 
 
 void FROM_TO_CACHE::Rebuild( BOARD* aBoard )
 {
+    std::vector<FT_ENDPOINT> prevEndpoints;
+    bool                     sameBoard = ( aBoard == m_board );
+
+    std::swap( prevEndpoints, m_ftEndpoints );
+
     m_board = aBoard;
     buildEndpointList();
+
+    if( !sameBoard || prevEndpoints != m_ftEndpoints )
+        Clear();
+}
+
+
+void FROM_TO_CACHE::InvalidateNets( const std::vector<int>& aNets )
+{
+    if( aNets.empty() || m_ftQueries.empty() )
+        return;
+
+    std::set<int> nets( aNets.begin(), aNets.end() );
+
+    for( auto it = m_ftQueries.begin(); it != m_ftQueries.end(); )
+    {
+        const std::set<int>& queryNets = it->second.nets;
+
+        if( std::any_of( queryNets.begin(), queryNets.end(),
+                         [&nets]( int aNet ) { return nets.count( aNet ) > 0; } ) )
+        {
+            it = m_ftQueries.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Every path belongs to exactly one query, and goes with it
+    m_ftPaths.erase( std::remove_if( m_ftPaths.begin(), m_ftPaths.end(),
+                                     [this]( const FT_PATH& aPath )
+                                     {
+                                         return !m_ftQueries.count( std::make_pair(
+                                                 aPath.fromWildcard, aPath.toWildcard ) );
+                                     } ),
+                     m_ftPaths.end() );
+}
+
+
+void FROM_TO_CACHE::Clear()
+{
     m_ftPaths.clear();
+    m_ftQueries.clear();
 }
 
 
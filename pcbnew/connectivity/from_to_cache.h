@@ -20,7 +20,9 @@
 #ifndef __FROM_TO_CACHE_H
 #define __FROM_TO_CACHE_H
 
+#include <map>
 #include <set>
+#include <vector>
 
 class PAD;
 class BOARD_CONNECTED_ITEM;
@@ -33,6 +35,11 @@ public:
     {
         wxString name;
         PAD* parent;
+
+        bool operator==( const FT_ENDPOINT& aOther ) const
+        {
+            return parent == aOther.parent && name == aOther.name;
+        }
     };
 
     struct FT_PATH
@@ -55,19 +62,47 @@ public:
     {
     }
 
+    /**
+     * Prepare the cache for a DRC run on \a aBoard.
+     *
+     * Cached paths are kept unless pads were added, removed or renamed since the last call,
+     * as that can change which pads a from/to wildcard matches.  Paths on modified nets are
+     * dropped as the board changes, see InvalidateNets().
+     */
     void Rebuild( BOARD* aBoard );
+
+    /**
+     * Drop the cached queries which depend on any of \a aNets.
+     *
+     * A query depends on the nets of all pads matching its "from" wildcard.  It is searched
+     * again the next time it is used.
+     */
+    void InvalidateNets( const std::vector<int>& aNets );
+
+    /// Drop all cached paths.
+    void Clear();
+
     bool IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom, const wxString& aTo );
 
     FT_PATH* QueryFromToPath( const std::set<BOARD_CONNECTED_ITEM*>& aItems );
 
 private:
 
+    struct FT_QUERY
+    {
+        std::set<int>                   nets;       ///< Nets of the pads matching "from"
+        std::set<BOARD_CONNECTED_ITEM*> items;      ///< Items on any path of the query
+    };
+
     int cacheFromToPaths( const wxString& aFrom, const wxString& aTo );
     void buildEndpointList();
 
     std::vector<FT_ENDPOINT> m_ftEndpoints;
     std::vector<FT_PATH> m_ftPaths;
 
+    ///< Cached queries, keyed by their from and to wildcards
+    std::map<std::pair<wxString, wxString>, FT_QUERY> m_ftQueries;
+
     BOARD* m_board;
 };
 
@@ -34,7 +34,6 @@
 #include <view/view_controls.h>
 #include <pcb_painter.h>
 #include <connectivity/connectivity_data.h>
-#include <connectivity/connectivity_algo.h>
 #include <dialogs/dialog_text_entry.h>
 #include <validators.h>
 #include <bitmaps.h>
@@ -1011,51 +1010,6 @@ bool DIALOG_NET_INSPECTOR::netFilterMatches( NETINFO_ITEM* aNet ) const
 }
 
 
-struct NETCODE_CMP_LESS
-{
-    bool operator()( const CN_ITEM* a, const CN_ITEM* b ) const
-    {
-        return a->Net() < b->Net();
-    }
-
-    bool operator()( const CN_ITEM* a, int b ) const
-    {
-        return a->Net() < b;
-    }
-
-    bool operator()( int a, const CN_ITEM* b ) const
-    {
-        return a < b->Net();
-    }
-};
-
-
-std::vector<CN_ITEM*> DIALOG_NET_INSPECTOR::relevantConnectivityItems() const
-{
-    // pre-filter the connectivity items and sort them by netcode.
-    // this avoids quadratic runtime when building the whole net list and
-    // calculating the total length for each net.
-
-    const auto type_bits = std::bitset<MAX_STRUCT_TYPE_ID>()
-            .set( PCB_TRACE_T )
-            .set( PCB_VIA_T )
-            .set( PCB_PAD_T );
-
-    std::vector<CN_ITEM*> cn_items;
-    cn_items.reserve( 1024 );
-
-    for( CN_ITEM* cn_item : m_brd->GetConnectivity()->GetConnectivityAlgo()->ItemList() )
-    {
-        if( cn_item->Valid() && type_bits[cn_item->Parent()->Type()] )
-            cn_items.push_back( cn_item );
-    }
-
-    std::sort( cn_items.begin(), cn_items.end(), NETCODE_CMP_LESS() );
-
-    return cn_items;
-}
-
-
 void DIALOG_NET_INSPECTOR::updateDisplayedRowValues( const OPT<LIST_ITEM_ITER>& aRow )
 {
     if( !aRow )
@@ -1115,65 +1069,9 @@ void DIALOG_NET_INSPECTOR::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardIt
             m_data_model->addItem( std::move( new_item ) );
         }
     }
-    else if( BOARD_CONNECTED_ITEM* i = dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) )
-    {
-        OPT<LIST_ITEM_ITER> r = m_data_model->findItem( i->GetNet() );
-
-        if( r )
-        {
-            // try to handle frequent operations quickly.
-            if( TRACK* track = dynamic_cast<TRACK*>( i ) )
-            {
-                const std::unique_ptr<LIST_ITEM>& list_item = *r.get();
-                int len = track->GetLength();
-
-                list_item->AddBoardWireLength( len );
-
-                if( track->Type() == PCB_VIA_T )
-                {
-                    list_item->AddViaCount( 1 );
-                    list_item->AddViaLength( calculateViaLength( track ) );
-                }
-
-                updateDisplayedRowValues( r );
-                return;
-            }
-        }
-
-        // resort to generic slower net update otherwise.
-        updateNet( i->GetNet() );
-    }
-    else if( FOOTPRINT* footprint = dynamic_cast<FOOTPRINT*>( aBoardItem ) )
+    else
     {
-        for( const PAD* pad : footprint->Pads() )
-        {
-            OPT<LIST_ITEM_ITER> r = m_data_model->findItem( pad->GetNet() );
-
-            if( !r )
-            {
-                // if show-zero-pads is off, we might not have this net
-                // in our list yet, so add it first.
-                // notice that at this point we are very certain that this net
-                // will have at least one pad.
-
-                if( netFilterMatches( pad->GetNet() ) )
-                    r = m_data_model->addItem( std::make_unique<LIST_ITEM>( pad->GetNet() ) );
-            }
-
-            if( r )
-            {
-                const std::unique_ptr<LIST_ITEM>& list_item = *r.get();
-                int len = pad->GetPadToDieLength();
-
-                list_item->AddPadCount( 1 );
-                list_item->AddChipWireLength( len );
-
-                if( list_item->GetPadCount() == 0 && !m_cbShowZeroPad->IsChecked() )
-                    m_data_model->deleteItem( r );
-                else
-                    updateDisplayedRowValues( r );
-            }
-        }
+        queueItemNets( aBoardItem );
     }
 }
 
@@ -1191,56 +1089,12 @@ void DIALOG_NET_INSPECTOR::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoard
 {
     if( NETINFO_ITEM* net = dynamic_cast<NETINFO_ITEM*>( aBoardItem ) )
     {
+        m_pending_nets.erase( net->GetNetCode() );
         m_data_model->deleteItem( m_data_model->findItem( net ) );
     }
-    else if( FOOTPRINT* footprint = dynamic_cast<FOOTPRINT*>( aBoardItem ) )
-    {
-        for( const PAD* pad : footprint->Pads() )
-        {
-            OPT<LIST_ITEM_ITER> r = m_data_model->findItem( pad->GetNet() );
-
-            if( r )
-            {
-                const std::unique_ptr<LIST_ITEM>& list_item = *r.get();
-                int len = pad->GetPadToDieLength();
-
-                list_item->SubPadCount( 1 );
-                list_item->SubChipWireLength( len );
-
-                if( list_item->GetPadCount() == 0 && !m_cbShowZeroPad->IsChecked() )
-                    m_data_model->deleteItem( r );
-                else
-                    updateDisplayedRowValues( r );
-            }
-        }
-    }
-    else if( BOARD_CONNECTED_ITEM* i = dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) )
+    else
     {
-        OPT<LIST_ITEM_ITER> r = m_data_model->findItem( i->GetNet() );
-
-        if( r )
-        {
-            // try to handle frequent operations quickly.
-            if( TRACK* track = dynamic_cast<TRACK*>( i ) )
-            {
-                const std::unique_ptr<LIST_ITEM>& list_item = *r.get();
-                int len = track->GetLength();
-
-                list_item->SubBoardWireLength( len );
-
-                if( track->Type() == PCB_VIA_T )
-                {
-                    list_item->SubViaCount( 1 );
-                    list_item->SubViaLength( calculateViaLength( track ) );
-                }
-
-                updateDisplayedRowValues( r );
-                return;
-            }
-
-            // resort to generic slower net update otherwise.
-            updateNet( i->GetNet() );
-        }
+        queueItemNets( aBoardItem );
     }
 }
 
@@ -1257,11 +1111,13 @@ void DIALOG_NET_INSPECTOR::OnBoardItemsRemoved( BOARD& aBoard,
 
 void DIALOG_NET_INSPECTOR::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem )
 {
+    // the item could have been moved to another net.  the previous net is not known
+    // anymore, so all rows need to be refreshed.
     if( dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) != nullptr
             || dynamic_cast<FOOTPRINT*>( aBoardItem ) != nullptr )
     {
-        buildNetsList();
-        m_netsList->Refresh();
+        m_pending_rebuild = true;
+        schedulePendingUpdate();
     }
 }
 
@@ -1269,8 +1125,71 @@ void DIALOG_NET_INSPECTOR::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoard
 void DIALOG_NET_INSPECTOR::OnBoardItemsChanged( BOARD& aBoard,
                                                 std::vector<BOARD_ITEM*>& aBoardItems )
 {
-    buildNetsList();
-    m_netsList->Refresh();
+    m_pending_rebuild = true;
+    schedulePendingUpdate();
+}
+
+
+void DIALOG_NET_INSPECTOR::queueItemNets( BOARD_ITEM* aBoardItem )
+{
+    if( BOARD_CONNECTED_ITEM* i = dynamic_cast<BOARD_CONNECTED_ITEM*>( aBoardItem ) )
+    {
+        m_pending_nets.insert( i->GetNetCode() );
+    }
+    else if( FOOTPRINT* footprint = dynamic_cast<FOOTPRINT*>( aBoardItem ) )
+    {
+        for( const PAD* pad : footprint->Pads() )
+            m_pending_nets.insert( pad->GetNetCode() );
+    }
+    else
+    {
+        return;
+    }
+
+    schedulePendingUpdate();
+}
+
+
+void DIALOG_NET_INSPECTOR::schedulePendingUpdate()
+{
+    if( m_update_pending )
+        return;
+
+    m_update_pending = true;
+
+    // board listeners are notified before the connectivity data has been recalculated,
+    // so the net statistics can only be read once the current event has been handled.
+    // this also merges all the notifications of one commit into a single update.
+    CallAfter( [this]()
+               {
+                   processPendingUpdate();
+               } );
+}
+
+
+void DIALOG_NET_INSPECTOR::processPendingUpdate()
+{
+    m_update_pending = false;
+
+    if( !m_brd )
+        return;
+
+    if( m_pending_rebuild )
+    {
+        buildNetsList();
+        m_netsList->Refresh();
+    }
+    else
+    {
+        for( int netcode : m_pending_nets )
+        {
+            if( NETINFO_ITEM* net = m_brd->FindNet( netcode ) )
+                updateNet( net );
+        }
+    }
+
+    m_pending_rebuild = false;
+    m_pending_nets.clear();
 }
 
 
@@ -1324,17 +1243,14 @@ void DIALOG_NET_INSPECTOR::updateNet( NETINFO_ITEM* aNet )
 
     OPT<LIST_ITEM_ITER> cur_net_row = m_data_model->findItem( aNet );
 
-    const unsigned int node_count = m_brd->GetNodesCount( aNet->GetNetCode() );
+    std::unique_ptr<LIST_ITEM> new_list_item = buildNewItem( aNet );
 
-    if( node_count == 0 && !m_cbShowZeroPad->IsChecked() )
+    if( new_list_item->GetPadCount() == 0 && !m_cbShowZeroPad->IsChecked() )
     {
         m_data_model->deleteItem( cur_net_row );
         return;
     }
 
-    std::unique_ptr<LIST_ITEM> new_list_item = buildNewItem( aNet, node_count,
-                                                             relevantConnectivityItems() );
-
     if( !cur_net_row )
     {
         m_data_model->addItem( std::move( new_list_item ) );
@@ -1355,6 +1271,7 @@ void DIALOG_NET_INSPECTOR::updateNet( NETINFO_ITEM* aNet )
         // update fields only
         cur_list_item->SetPadCount( new_list_item->GetPadCount() );
         cur_list_item->SetViaCount( new_list_item->GetViaCount() );
+        cur_list_item->SetViaLength( new_list_item->GetViaLength() );
         cur_list_item->SetBoardWireLength( new_list_item->GetBoardWireLength() );
         cur_list_item->SetChipWireLength( new_list_item->GetChipWireLength() );
 
@@ -1363,9 +1280,9 @@ void DIALOG_NET_INSPECTOR::updateNet( NETINFO_ITEM* aNet )
 }
 
 
-unsigned int DIALOG_NET_INSPECTOR::calculateViaLength( const TRACK* aTrack ) const
+unsigned int DIALOG_NET_INSPECTOR::calculateViaLength( PCB_LAYER_ID aTopLayer,
+                                                       PCB_LAYER_ID aBottomLayer ) const
 {
-    const VIA& via = dynamic_cast<const VIA&>( *aTrack );
     BOARD_DESIGN_SETTINGS& bds = m_brd->GetDesignSettings();
 
     // calculate the via length individually from the board stackup and via's start and end layer.
@@ -1373,8 +1290,8 @@ unsigned int DIALOG_NET_INSPECTOR::calculateViaLength( const TRACK* aTrack ) con
     {
         const BOARD_STACKUP& stackup = bds.GetStackupDescriptor();
 
-        std::pair<PCB_LAYER_ID, int> layer_dist[2] = { std::make_pair( via.TopLayer(), 0 ),
-                                                       std::make_pair( via.BottomLayer(), 0 ) };
+        std::pair<PCB_LAYER_ID, int> layer_dist[2] = { std::make_pair( aTopLayer, 0 ),
+                                                       std::make_pair( aBottomLayer, 0 ) };
 
         for( const BOARD_STACKUP_ITEM* i : stackup.GetList() )
         {
@@ -1396,12 +1313,12 @@ unsigned int DIALOG_NET_INSPECTOR::calculateViaLength( const TRACK* aTrack ) con
         int layerThickness = bds.GetBoardThickness() / dielectricLayers;
         int effectiveBottomLayer;
 
-        if( via.BottomLayer() == B_Cu )
+        if( aBottomLayer == B_Cu )
             effectiveBottomLayer = F_Cu + dielectricLayers;
         else
-            effectiveBottomLayer = via.BottomLayer();
+            effectiveBottomLayer = aBottomLayer;
 
-        int layerCount = effectiveBottomLayer - via.TopLayer();
+        int layerCount = effectiveBottomLayer - aTopLayer;
 
         return layerCount * layerThickness;
     }
@@ -1409,34 +1326,22 @@ unsigned int DIALOG_NET_INSPECTOR::calculateViaLength( const TRACK* aTrack ) con
 
 
 std::unique_ptr<DIALOG_NET_INSPECTOR::LIST_ITEM>
-DIALOG_NET_INSPECTOR::buildNewItem( NETINFO_ITEM* aNet, unsigned int aPadCount,
-                                    const std::vector<CN_ITEM*>& aCNItems )
+DIALOG_NET_INSPECTOR::buildNewItem( NETINFO_ITEM* aNet ) const
 {
     std::unique_ptr<LIST_ITEM> new_item = std::make_unique<LIST_ITEM>( aNet );
 
-    new_item->SetPadCount( aPadCount );
+    // the connectivity keeps these values up to date for each net, so there is no need
+    // to walk over the board items here.
+    const CN_NET_STATS& stats = m_brd->GetConnectivity()->GetNetStats( aNet->GetNetCode() );
 
-    const auto cn_items = std::equal_range( aCNItems.begin(), aCNItems.end(), aNet->GetNetCode(),
-                                            NETCODE_CMP_LESS() );
-
-    for( auto i = cn_items.first; i != cn_items.second; ++i )
-    {
-        BOARD_CONNECTED_ITEM* item = ( *i )->Parent();
-
-        if( item->Type() == PCB_PAD_T )
-            new_item->AddChipWireLength( static_cast<PAD*>( item )->GetPadToDieLength() );
-
-        else if( TRACK* track = dynamic_cast<TRACK*>( item ) )
-        {
-            new_item->AddBoardWireLength( track->GetLength() );
+    new_item->SetPadCount( stats.m_PadCount );
+    new_item->SetViaCount( stats.m_ViaCount );
+    new_item->SetBoardWireLength( stats.m_RoutedLength );
+    new_item->SetChipWireLength( stats.m_PadToDieLength );
 
-            if( item->Type() == PCB_VIA_T )
-            {
-                new_item->AddViaCount( 1 );
-                new_item->AddViaLength( calculateViaLength( track ) );
-            }
-        }
-    }
+    for( const auto& span : stats.m_ViaSpans )
+        new_item->AddViaLength( span.second * calculateViaLength( span.first.first,
+                                                                  span.first.second ) );
 
     return new_item;
 }
@@ -1480,68 +1385,20 @@ void DIALOG_NET_INSPECTOR::buildNetsList()
         }
     }
 
-    std::vector<CN_ITEM*> prefiltered_cn_items = relevantConnectivityItems();
-
-
-    // collect all nets which pass the filter string and also remember the
-    // suffix after the filter match, if any.
-    struct NET_INFO
-    {
-        int           netcode;
-        NETINFO_ITEM* net;
-        unsigned int  pad_count;
-    };
-
-    struct NET_INFO_CMP_LESS
-    {
-        bool operator()( const NET_INFO& a, const NET_INFO& b ) const
-        {
-            return a.netcode < b.netcode;
-        }
-        bool operator()( const NET_INFO& a, int b ) const
-        {
-            return a.netcode < b;
-        }
-        bool operator()( int a, const NET_INFO& b ) const
-        {
-            return a < b.netcode;
-        }
-    };
-
-    std::vector<NET_INFO> nets;
-    nets.reserve( m_brd->GetNetInfo().NetsByNetcode().size() );
-
-    for( const std::pair<int, NETINFO_ITEM*> ni : m_brd->GetNetInfo().NetsByNetcode() )
+    for( const std::pair<const int, NETINFO_ITEM*>& ni : m_brd->GetNetInfo().NetsByNetcode() )
     {
         if( ni.first == 0 )
             m_zero_netitem = ni.second;
 
-        if( netFilterMatches( ni.second ) )
-            nets.emplace_back( NET_INFO{ ni.first, ni.second, 0 } );
-    }
+        if( !netFilterMatches( ni.second ) )
+            continue;
 
-    // count the pads for each net.  since the nets are sorted by netcode
-    // iterating over the footprints' pads is faster.
+        std::unique_ptr<LIST_ITEM> new_item = buildNewItem( ni.second );
 
-    for( FOOTPRINT* footprint : m_brd->Footprints() )
-    {
-        for( PAD* pad : footprint->Pads() )
-        {
-            auto i = std::lower_bound( nets.begin(), nets.end(), pad->GetNetCode(),
-                                       NET_INFO_CMP_LESS() );
-
-            if( i != nets.end() && i->netcode == pad->GetNetCode() )
-                i->pad_count += 1;
-        }
+        if( m_cbShowZeroPad->IsChecked() || new_item->GetPadCount() > 0 )
+            new_items.emplace_back( std::move( new_item ) );
     }
 
-    for( NET_INFO& ni : nets )
-    {
-        if( m_cbShowZeroPad->IsChecked() || ni.pad_count > 0 )
-            new_items.emplace_back( buildNewItem( ni.net, ni.pad_count, prefiltered_cn_items ) );
-    }
-
-
     m_data_model->addItems( std::move( new_items ) );
 
     // try to restore the selected rows.  set the ones that we can't find anymore to -1.
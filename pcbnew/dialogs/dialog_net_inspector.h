@@ -26,12 +26,12 @@
 #pragma once
 
 #include <core/optional.h>
+#include <set>
 #include <dialog_net_inspector_base.h>
 
 class PCB_EDIT_FRAME;
 class NETINFO_ITEM;
 class BOARD;
-class CN_ITEM;
 class EDA_PATTERN_MATCH;
 
 class DIALOG_NET_INSPECTOR : public DIALOG_NET_INSPECTOR_BASE, public BOARD_LISTENER
@@ -86,10 +86,13 @@ private:
     wxString formatCount( unsigned int aValue ) const;
     wxString formatLength( int64_t aValue ) const;
 
-    std::vector<CN_ITEM*> relevantConnectivityItems() const;
-    bool                  netFilterMatches( NETINFO_ITEM* aNet ) const;
-    void                  updateNet( NETINFO_ITEM* aNet );
-    unsigned int          calculateViaLength( const TRACK* ) const;
+    bool         netFilterMatches( NETINFO_ITEM* aNet ) const;
+    void         updateNet( NETINFO_ITEM* aNet );
+    unsigned int calculateViaLength( PCB_LAYER_ID aTopLayer, PCB_LAYER_ID aBottomLayer ) const;
+
+    void queueItemNets( BOARD_ITEM* aBoardItem );
+    void schedulePendingUpdate();
+    void processPendingUpdate();
 
     void onSelChanged( wxDataViewEvent& event ) override;
     void onSelChanged();
@@ -101,8 +104,7 @@ private:
     void onDeleteNet( wxCommandEvent& event ) override;
     void onReport( wxCommandEvent& event ) override;
 
-    std::unique_ptr<LIST_ITEM> buildNewItem( NETINFO_ITEM* aNet, unsigned int aPadCount,
-                                             const std::vector<CN_ITEM*>& aCNItems );
+    std::unique_ptr<LIST_ITEM> buildNewItem( NETINFO_ITEM* aNet ) const;
 
     void buildNetsList();
     void adjustListColumns();
@@ -126,6 +128,11 @@ private:
     bool            m_in_build_nets_list = false;
     bool            m_filter_change_no_rebuild = false;
 
+    // board changes are applied once the connectivity has been updated.
+    std::set<int>   m_pending_nets;
+    bool            m_pending_rebuild = false;
+    bool            m_update_pending = false;
+
     class DATA_MODEL;
     wxObjectDataPtr<DATA_MODEL> m_data_model;
 };
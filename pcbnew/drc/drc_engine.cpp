@@ -35,6 +35,7 @@
 #include <geometry/shape.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_null.h>
+#include <atomic>
 
 void drcPrintDebugMessage( int level, const wxString& msg, const char *function, int line )
 {
@@ -58,6 +59,7 @@ DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     m_worksheet( nullptr ),
     m_schematicNetlist( nullptr ),
     m_rulesValid( false ),
+    m_rulesSerial( 0 ),
     m_userUnits( EDA_UNITS::MILLIMETRES ),
     m_reportAllTrackErrors( false ),
     m_testFootprints( false ),
@@ -607,8 +609,11 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
     for( DRC_RULE* rule : m_rules )
         delete rule;
 
+    static std::atomic<unsigned> s_rulesSerial( 0 );
+
     m_rules.clear();
     m_rulesValid = false;
+    m_rulesSerial = ++s_rulesSerial;
 
     for( std::pair<DRC_CONSTRAINT_T, std::vector<DRC_ENGINE_CONSTRAINT*>*> pair : m_constraintMap )
     {
@@ -1095,6 +1100,23 @@ bool DRC_ENGINE::HasRulesForConstraintType( DRC_CONSTRAINT_T constraintID )
 }
 
 
+std::vector<DRC_RULE*> DRC_ENGINE::GetRulesForConstraintType( DRC_CONSTRAINT_T aConstraintId )
+{
+    std::vector<DRC_RULE*> rules;
+
+    if( m_constraintMap.count( aConstraintId ) )
+    {
+        for( DRC_ENGINE_CONSTRAINT* c : *m_constraintMap[aConstraintId] )
+        {
+            if( c->parentRule && ( rules.empty() || rules.back() != c->parentRule ) )
+                rules.push_back( c->parentRule );
+        }
+    }
+
+    return rules;
+}
+
+
 bool DRC_ENGINE::QueryWorstConstraint( DRC_CONSTRAINT_T aConstraintId, DRC_CONSTRAINT& aConstraint )
 {
     int worst = 0;
@@ -148,12 +148,23 @@ public:
 
     bool HasRulesForConstraintType( DRC_CONSTRAINT_T constraintID );
 
+    /**
+     * @return the rules providing \a aConstraintId constraints, in evaluation order.
+     */
+    std::vector<DRC_RULE*> GetRulesForConstraintType( DRC_CONSTRAINT_T aConstraintId );
+
     EDA_UNITS UserUnits() const { return m_userUnits; }
     bool GetReportAllTrackErrors() const { return m_reportAllTrackErrors; }
     bool GetTestFootprints() const { return m_testFootprints; }
 
     bool RulesValid() { return m_rulesValid; }
 
+    /**
+     * @return a number identifying the rule set loaded by the last InitEngine() call.  It is
+     *         unique across engines, so callers can cache anything derived from the rules.
+     */
+    unsigned GetRulesSerial() const { return m_rulesSerial; }
+
     void ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos );
     bool ReportProgress( double aProgress );
     bool ReportPhase( const wxString& aMessage );
@@ -205,6 +216,7 @@ protected:
 
     std::vector<DRC_RULE*>           m_rules;
     bool                             m_rulesValid;
+    unsigned                         m_rulesSerial;
     std::vector<DRC_TEST_PROVIDER*>  m_testProviders;
 
     EDA_UNITS                        m_userUnits;
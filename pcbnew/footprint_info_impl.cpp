@@ -48,19 +48,21 @@ void FOOTPRINT_INFO_IMPL::load()
 
     wxASSERT( fptable );
 
-    const FOOTPRINT* footprint = fptable->GetEnumeratedFootprint( m_nickname, m_fpname );
+    // Plugins keeping a library index can answer this without parsing the footprint.
+    FOOTPRINT_METADATA metadata;
 
-    if( footprint == NULL ) // Should happen only with malformed/broken libraries
+    if( !fptable->GetFootprintMetadata( m_nickname, m_fpname, metadata ) )
     {
+        // Should happen only with malformed/broken libraries
         m_pad_count = 0;
         m_unique_pad_count = 0;
     }
     else
     {
-        m_pad_count = footprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
-        m_unique_pad_count = footprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
-        m_keywords = footprint->GetKeywords();
-        m_doc = footprint->GetDescription();
+        m_pad_count = metadata.m_PadCount;
+        m_unique_pad_count = metadata.m_UniquePadCount;
+        m_keywords = metadata.m_Keywords;
+        m_doc = metadata.m_Description;
     }
 
     m_loaded = true;
@@ -236,6 +236,23 @@ public:
 };
 
 
+/**
+ * The subset of a footprint's data needed to list it in a footprint browser.
+ */
+struct FOOTPRINT_METADATA
+{
+    FOOTPRINT_METADATA() :
+            m_PadCount( 0 ),
+            m_UniquePadCount( 0 )
+    { }
+
+    wxString m_Description;
+    wxString m_Keywords;
+    unsigned m_PadCount;            ///< Pad count, excluding NPTH pads
+    unsigned m_UniquePadCount;      ///< Unique pad count, excluding NPTH pads
+};
+
+
 /**
  * A base class that #BOARD loading and saving plugins should derive from.
  *
@@ -411,6 +428,26 @@ public:
                                                      const wxString& aFootprintName,
                                                      const PROPERTIES* aProperties = nullptr );
 
+    /**
+     * Fetch the description, keywords and pad counts of a footprint without necessarily
+     * loading the whole footprint.
+     *
+     * Plugins which keep an index of their libraries should override this; the default
+     * implementation goes through GetEnumeratedFootprint().
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file, or URL
+     *                     containing several footprints.
+     * @param aFootprintName is the name of the footprint.
+     * @param aMetadata is filled with the footprint metadata.
+     * @return true if the footprint was found, false otherwise.
+     *
+     * @throw IO_ERROR if the library cannot be found or read.
+     */
+    virtual bool GetFootprintMetadata( const wxString& aLibraryPath,
+                                       const wxString& aFootprintName,
+                                       FOOTPRINT_METADATA& aMetadata,
+                                       const PROPERTIES* aProperties = nullptr );
+
     /**
      * Check for the existence of a footprint.
      */
@@ -349,6 +349,8 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
     routeMenu->Add( PCB_ACTIONS::routerTuneSingleTrace );
     routeMenu->Add( PCB_ACTIONS::routerTuneDiffPair );
     routeMenu->Add( PCB_ACTIONS::routerTuneDiffPairSkew );
+    routeMenu->Add( PCB_ACTIONS::routerTuneSelectedTracks );
+    routeMenu->Add( PCB_ACTIONS::routerTuneSelectedDiffPairs );
 
     routeMenu->AppendSeparator();
     routeMenu->Add( PCB_ACTIONS::routerSettingsDialog );
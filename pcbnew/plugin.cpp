@@ -23,6 +23,7 @@
  */
 
 #include <io_mgr.h>
+#include <footprint.h>
 #include <properties.h>
 #include <wx/translation.h>
 
@@ -88,6 +89,25 @@ const FOOTPRINT* PLUGIN::GetEnumeratedFootprint( const wxString& aLibraryPath,
 }
 
 
+bool PLUGIN::GetFootprintMetadata( const wxString& aLibraryPath, const wxString& aFootprintName,
+                                   FOOTPRINT_METADATA& aMetadata, const PROPERTIES* aProperties )
+{
+    // default implementation
+    const FOOTPRINT* footprint = GetEnumeratedFootprint( aLibraryPath, aFootprintName,
+                                                         aProperties );
+
+    if( !footprint )
+        return false;
+
+    aMetadata.m_Description = footprint->GetDescription();
+    aMetadata.m_Keywords = footprint->GetKeywords();
+    aMetadata.m_PadCount = footprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
+    aMetadata.m_UniquePadCount = footprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
+
+    return true;
+}
+
+
 bool PLUGIN::FootprintExists( const wxString& aLibraryPath, const wxString& aFootprintName,
                               const PROPERTIES* aProperties )
 {
@@ -0,0 +1,484 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <vector>
+
+#include <wx/dir.h>
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/translation.h>
+
+#include <footprint.h>
+#include <ki_exception.h>
+#include <macros.h>
+#include <paths.h>
+#include <trace_helpers.h>
+#include <wildcards_and_files_ext.h>
+#include <plugins/kicad/kicad_plugin.h>
+#include <plugins/kicad/fp_cache_index.h>
+
+
+/// Bump this whenever the layout of the records below changes.
+#define FP_CACHE_INDEX_FORMAT_VERSION 1
+
+static const char indexMagic[8] = { 'K', 'I', 'F', 'P', 'I', 'D', 'X', '\0' };
+
+
+/*
+ * The records are made only of naturally aligned fixed width fields so that they have the
+ * same layout on every platform we build for, and can be read in place.
+ */
+struct INDEX_HEADER
+{
+    char     magic[8];
+    uint32_t formatVersion;
+    uint32_t parserVersion;
+    uint32_t entryCount;
+    uint32_t stringTableSize;
+};
+
+
+struct INDEX_STRING_REF
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+
+struct INDEX_RECORD
+{
+    int64_t          timestamp;
+    int64_t          size;
+    INDEX_STRING_REF name;
+    INDEX_STRING_REF fileName;
+    INDEX_STRING_REF description;
+    INDEX_STRING_REF keywords;
+    uint32_t         padCount;
+    uint32_t         uniquePadCount;
+};
+
+
+static_assert( sizeof( INDEX_HEADER ) == 24, "unexpected padding in INDEX_HEADER" );
+static_assert( sizeof( INDEX_RECORD ) == 56, "unexpected padding in INDEX_RECORD" );
+
+
+/**
+ * A minimal s-expression tokenizer, just good enough to pick the metadata out of a footprint
+ * file.  Lists are returned as "(" and ")" tokens and quoted strings are returned unquoted.
+ */
+class FP_FILE_SCANNER
+{
+public:
+    FP_FILE_SCANNER( const std::string& aText ) :
+            m_text( aText ),
+            m_pos( 0 ),
+            m_depth( 0 )
+    { }
+
+    /// @return the number of lists open at the current position.
+    int Depth() const { return m_depth; }
+
+    bool Next( std::string& aToken )
+    {
+        while( m_pos < m_text.size() && isspace( (unsigned char) m_text[m_pos] ) )
+            m_pos++;
+
+        if( m_pos >= m_text.size() )
+            return false;
+
+        char c = m_text[m_pos++];
+
+        aToken.clear();
+
+        if( c == '(' || c == ')' )
+        {
+            m_depth += ( c == '(' ) ? 1 : -1;
+            aToken += c;
+        }
+        else if( c == '"' )
+        {
+            while( m_pos < m_text.size() && m_text[m_pos] != '"' )
+            {
+                c = m_text[m_pos++];
+
+                if( c == '\\' && m_pos < m_text.size() )
+                {
+                    c = m_text[m_pos++];
+
+                    if( c == 'n' )
+                        c = '\n';
+                    else if( c == 't' )
+                        c = '\t';
+                }
+
+                aToken += c;
+            }
+
+            m_pos++;    // closing quote
+        }
+        else
+        {
+            aToken += c;
+
+            while( m_pos < m_text.size() && !isspace( (unsigned char) m_text[m_pos] )
+                    && m_text[m_pos] != '(' && m_text[m_pos] != ')' )
+            {
+                aToken += m_text[m_pos++];
+            }
+        }
+
+        return true;
+    }
+
+private:
+    const std::string& m_text;
+    size_t             m_pos;
+    int                m_depth;
+};
+
+
+FP_CACHE_INDEX::FP_CACHE_INDEX( const wxString& aLibraryPath ) :
+        m_libPath( aLibraryPath )
+{
+}
+
+
+wxString FP_CACHE_INDEX::GetIndexFileName( const wxString& aLibraryPath )
+{
+    wxFileName fn;
+
+    fn.AssignDir( PATHS::GetUserCachePath() );
+    fn.AppendDir( wxT( "footprints" ) );
+
+    size_t hash = std::hash<std::string>()( TO_UTF8( aLibraryPath ) );
+
+    fn.SetName( wxFileName( aLibraryPath ).GetName() + wxString::Format( wxT( "-%016llx" ),
+                                                                        (unsigned long long) hash ) );
+    fn.SetExt( wxT( "fpidx" ) );
+
+    return fn.GetFullPath();
+}
+
+
+bool FP_CACHE_INDEX::StatFile( const wxString& aFullPath, long long& aTimestamp, long long& aSize )
+{
+    wxStructStat st;
+
+    if( wxStat( aFullPath, &st ) != 0 )
+        return false;
+
+    aTimestamp = (long long) st.st_mtime;
+    aSize = (long long) st.st_size;
+    return true;
+}
+
+
+bool FP_CACHE_INDEX::Read()
+{
+    m_entries.clear();
+
+    wxString fileName = GetIndexFileName( m_libPath );
+
+    if( !wxFileName::FileExists( fileName ) )
+        return false;
+
+    wxFile file( fileName );
+
+    if( !file.IsOpened() )
+        return false;
+
+    wxFileOffset length = file.Length();
+
+    if( length < (wxFileOffset) sizeof( INDEX_HEADER ) )
+        return false;
+
+    std::vector<char> buffer( (size_t) length );
+
+    if( file.Read( buffer.data(), buffer.size() ) != (ssize_t) buffer.size() )
+        return false;
+
+    INDEX_HEADER header;
+    memcpy( &header, buffer.data(), sizeof( header ) );
+
+    if( memcmp( header.magic, indexMagic, sizeof( indexMagic ) ) != 0
+            || header.formatVersion != FP_CACHE_INDEX_FORMAT_VERSION
+            || header.parserVersion != SEXPR_BOARD_FILE_VERSION )
+    {
+        wxLogTrace( traceKicadPcbPlugin, wxT( "Discarding stale footprint index '%s'." ),
+                    fileName );
+        return false;
+    }
+
+    size_t recordsStart = sizeof( INDEX_HEADER );
+    size_t stringsStart = recordsStart + (size_t) header.entryCount * sizeof( INDEX_RECORD );
+
+    if( stringsStart + header.stringTableSize != buffer.size() )
+        return false;
+
+    const char* strings = buffer.data() + stringsStart;
+
+    auto getString =
+            [&]( const INDEX_STRING_REF& aRef, wxString& aDest ) -> bool
+            {
+                if( (size_t) aRef.offset + aRef.length > header.stringTableSize )
+                    return false;
+
+                aDest = wxString::FromUTF8( strings + aRef.offset, aRef.length );
+                return true;
+            };
+
+    for( uint32_t ii = 0; ii < header.entryCount; ++ii )
+    {
+        INDEX_RECORD record;
+        memcpy( &record, buffer.data() + recordsStart + ii * sizeof( INDEX_RECORD ),
+                sizeof( record ) );
+
+        wxString             name;
+        FP_CACHE_INDEX_ENTRY entry;
+
+        if( !getString( record.name, name )
+                || !getString( record.fileName, entry.m_FileName )
+                || !getString( record.description, entry.m_Metadata.m_Description )
+                || !getString( record.keywords, entry.m_Metadata.m_Keywords ) )
+        {
+            m_entries.clear();
+            return false;
+        }
+
+        entry.m_Timestamp = record.timestamp;
+        entry.m_Size = record.size;
+        entry.m_Metadata.m_PadCount = record.padCount;
+        entry.m_Metadata.m_UniquePadCount = record.uniquePadCount;
+
+        m_entries[ name ] = entry;
+    }
+
+    return true;
+}
+
+
+void FP_CACHE_INDEX::Write() const
+{
+    wxFileName fn( GetIndexFileName( m_libPath ) );
+
+    if( !fn.DirExists() && !fn.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return;
+
+    std::vector<INDEX_RECORD> records;
+    std::string               strings;
+
+    auto addString =
+            [&]( const wxString& aString ) -> INDEX_STRING_REF
+            {
+                std::string      utf8 = TO_UTF8( aString );
+                INDEX_STRING_REF ref;
+
+                ref.offset = (uint32_t) strings.size();
+                ref.length = (uint32_t) utf8.size();
+                strings += utf8;
+                return ref;
+            };
+
+    records.reserve( m_entries.size() );
+
+    for( const std::pair<const wxString, FP_CACHE_INDEX_ENTRY>& pair : m_entries )
+    {
+        const FP_CACHE_INDEX_ENTRY& entry = pair.second;
+        INDEX_RECORD                record;
+
+        record.timestamp = entry.m_Timestamp;
+        record.size = entry.m_Size;
+        record.name = addString( pair.first );
+        record.fileName = addString( entry.m_FileName );
+        record.description = addString( entry.m_Metadata.m_Description );
+        record.keywords = addString( entry.m_Metadata.m_Keywords );
+        record.padCount = entry.m_Metadata.m_PadCount;
+        record.uniquePadCount = entry.m_Metadata.m_UniquePadCount;
+
+        records.push_back( record );
+    }
+
+    INDEX_HEADER header;
+    memcpy( header.magic, indexMagic, sizeof( indexMagic ) );
+    header.formatVersion = FP_CACHE_INDEX_FORMAT_VERSION;
+    header.parserVersion = SEXPR_BOARD_FILE_VERSION;
+    header.entryCount = (uint32_t) records.size();
+    header.stringTableSize = (uint32_t) strings.size();
+
+    // Write to a temporary file and rename it so that a concurrent reader never sees a
+    // partially written index.
+    wxString tempFileName = wxFileName::CreateTempFileName( fn.GetPath( wxPATH_GET_SEPARATOR ) );
+
+    {
+        wxFile file( tempFileName, wxFile::write );
+
+        if( !file.IsOpened() )
+            return;
+
+        bool ok = file.Write( &header, sizeof( header ) ) == sizeof( header );
+
+        if( ok && !records.empty() )
+        {
+            size_t size = records.size() * sizeof( INDEX_RECORD );
+            ok = file.Write( records.data(), size ) == size;
+        }
+
+        if( ok && !strings.empty() )
+            ok = file.Write( strings.data(), strings.size() ) == strings.size();
+
+        if( !ok )
+        {
+            file.Close();
+            wxRemoveFile( tempFileName );
+            return;
+        }
+    }
+
+    if( !wxRenameFile( tempFileName, fn.GetFullPath(), true ) )
+    {
+        // Not the end of the world, the index is just a cache.
+        wxRemoveFile( tempFileName );
+    }
+}
+
+
+void FP_CACHE_INDEX::Update( const wxString& aFootprintName, const wxString& aFileName,
+                             const FOOTPRINT* aFootprint )
+{
+    FP_CACHE_INDEX_ENTRY entry;
+
+    entry.m_FileName = aFileName;
+
+    if( !StatFile( m_libPath + wxT( '/' ) + aFileName, entry.m_Timestamp, entry.m_Size ) )
+    {
+        m_entries.erase( aFootprintName );
+        return;
+    }
+
+    entry.m_Metadata.m_Description = aFootprint->GetDescription();
+    entry.m_Metadata.m_Keywords = aFootprint->GetKeywords();
+    entry.m_Metadata.m_PadCount = aFootprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
+    entry.m_Metadata.m_UniquePadCount = aFootprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
+
+    m_entries[ aFootprintName ] = entry;
+}
+
+
+void FP_CACHE_INDEX::ScanFile( const wxString& aLibraryPath, const wxString& aFileName,
+                               FP_CACHE_INDEX_ENTRY& aEntry )
+{
+    wxString fullPath = aLibraryPath + wxT( '/' ) + aFileName;
+    wxFile   file;
+
+    if( !StatFile( fullPath, aEntry.m_Timestamp, aEntry.m_Size ) || !file.Open( fullPath ) )
+        THROW_IO_ERROR( wxString::Format( _( "Cannot open footprint file \"%s\"." ), fullPath ) );
+
+    std::string buffer( (size_t) aEntry.m_Size, '\0' );
+
+    if( file.Read( &buffer[0], buffer.size() ) != (ssize_t) buffer.size() )
+        THROW_IO_ERROR( wxString::Format( _( "Cannot read footprint file \"%s\"." ), fullPath ) );
+
+    aEntry.m_FileName = aFileName;
+    aEntry.m_Metadata = FOOTPRINT_METADATA();
+
+    FP_FILE_SCANNER       scanner( buffer );
+    std::string           token;
+    std::set<std::string> padNames;
+
+    // Only the direct children of the (footprint ...) list are of interest: (descr ...),
+    // (tags ...) and (pad ...).
+    while( scanner.Next( token ) )
+    {
+        if( token != "(" || scanner.Depth() != 2 )
+            continue;
+
+        if( !scanner.Next( token ) )
+            break;
+
+        if( token == "descr" || token == "tags" )
+        {
+            std::string value;
+
+            if( scanner.Next( value ) && value != ")" )
+            {
+                if( token == "descr" )
+                    aEntry.m_Metadata.m_Description = wxString::FromUTF8( value.c_str() );
+                else
+                    aEntry.m_Metadata.m_Keywords = wxString::FromUTF8( value.c_str() );
+            }
+        }
+        else if( token == "pad" )
+        {
+            // (pad <name> <type> <shape> ... (layers <layer>...) ...)
+            std::string padName;
+            std::string padType;
+            bool        onCopper = false;
+
+            if( !scanner.Next( padName ) || !scanner.Next( padType ) )
+                break;
+
+            while( scanner.Depth() > 1 && scanner.Next( token ) )
+            {
+                if( token != "(" || scanner.Depth() != 3 )
+                    continue;
+
+                if( scanner.Next( token ) && token == "layers" )
+                {
+                    while( scanner.Next( token ) && token != ")" )
+                    {
+                        if( token.size() > 3 && token.compare( token.size() - 3, 3, ".Cu" ) == 0 )
+                            onCopper = true;
+                    }
+                }
+            }
+
+            if( padType == "np_thru_hole" )
+                continue;
+
+            aEntry.m_Metadata.m_PadCount++;
+
+            if( onCopper && !padName.empty() )
+                padNames.insert( padName );
+        }
+    }
+
+    aEntry.m_Metadata.m_UniquePadCount = (unsigned) padNames.size();
+}
+
+
+const FP_CACHE_INDEX_ENTRY* FP_CACHE_INDEX::Find( const wxString& aFootprintName ) const
+{
+    auto it = m_entries.find( aFootprintName );
+
+    if( it == m_entries.end() )
+        return nullptr;
+
+    return &it->second;
+}
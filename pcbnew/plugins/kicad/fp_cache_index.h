@@ -0,0 +1,138 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef FP_CACHE_INDEX_H_
+#define FP_CACHE_INDEX_H_
+
+#include <map>
+#include <io_mgr.h>
+
+class FOOTPRINT;
+
+
+/**
+ * The metadata of a single footprint file as stored in a #FP_CACHE_INDEX.
+ */
+struct FP_CACHE_INDEX_ENTRY
+{
+    FP_CACHE_INDEX_ENTRY() :
+            m_Timestamp( 0 ),
+            m_Size( 0 )
+    { }
+
+    wxString           m_FileName;      ///< Footprint file name, without the library path.
+    long long          m_Timestamp;     ///< Last modification time of the footprint file.
+    long long          m_Size;          ///< Size in bytes of the footprint file.
+    FOOTPRINT_METADATA m_Metadata;
+};
+
+
+/**
+ * A binary sidecar cache holding the metadata of every footprint in a .pretty library.
+ *
+ * The index lets the footprint list and the footprint chooser be populated without running
+ * the s-expression parser over every footprint file.  Entries are keyed by the modification
+ * time and size of their footprint file, and the whole index is keyed by the parser version
+ * (#SEXPR_BOARD_FILE_VERSION), so any change to either invalidates it.
+ *
+ * Index files live in the user cache directory rather than next to the library, because
+ * system libraries are usually installed read only.
+ *
+ * The on-disk layout is a fixed size header, followed by an array of fixed size entry records
+ * and a string table.  All string references are offsets into the string table, so the file
+ * can be used directly from a single read (or a memory mapping) without any fix-ups.
+ */
+class FP_CACHE_INDEX
+{
+public:
+    FP_CACHE_INDEX( const wxString& aLibraryPath );
+
+    const wxString& GetLibraryPath() const { return m_libPath; }
+
+    bool IsPath( const wxString& aPath ) const { return aPath == m_libPath; }
+
+    /**
+     * Read the index file of the library.
+     *
+     * @return false if there is no index or it was written by another parser version.
+     */
+    bool Read();
+
+    /**
+     * Write the index file of the library.  Failures are silently ignored: the index is
+     * only a cache and will be rebuilt on the next full library load.
+     */
+    void Write() const;
+
+    /**
+     * Add or replace the entry for \a aFootprintName using the metadata of \a aFootprint.
+     */
+    void Update( const wxString& aFootprintName, const wxString& aFileName,
+                 const FOOTPRINT* aFootprint );
+
+    void Update( const wxString& aFootprintName, const FP_CACHE_INDEX_ENTRY& aEntry )
+    {
+        m_entries[ aFootprintName ] = aEntry;
+    }
+
+    void Remove( const wxString& aFootprintName ) { m_entries.erase( aFootprintName ); }
+
+    void Clear() { m_entries.clear(); }
+
+    /**
+     * @return the entry for \a aFootprintName or nullptr if the footprint is not indexed.
+     */
+    const FP_CACHE_INDEX_ENTRY* Find( const wxString& aFootprintName ) const;
+
+    /// Map of footprint name to its index entry.
+    const std::map<wxString, FP_CACHE_INDEX_ENTRY>& GetEntries() const { return m_entries; }
+
+    /**
+     * @return the full path of the index file used for the library at \a aLibraryPath.
+     */
+    static wxString GetIndexFileName( const wxString& aLibraryPath );
+
+    /**
+     * Fill \a aEntry by scanning the footprint file \a aFileName of \a aLibraryPath.
+     *
+     * This is a lexical scan for the description, keywords and pads of the footprint; it
+     * builds no board items and is several times faster than parsing the file.
+     *
+     * @throw IO_ERROR if the file cannot be read.
+     */
+    static void ScanFile( const wxString& aLibraryPath, const wxString& aFileName,
+                          FP_CACHE_INDEX_ENTRY& aEntry );
+
+    /**
+     * Fetch the modification time and size of \a aFullPath.
+     *
+     * @return false if the file cannot be stat'ed.
+     */
+    static bool StatFile( const wxString& aFullPath, long long& aTimestamp, long long& aSize );
+
+private:
+    wxString                                 m_libPath;
+    std::map<wxString, FP_CACHE_INDEX_ENTRY> m_entries;
+};
+
+#endif  // FP_CACHE_INDEX_H_
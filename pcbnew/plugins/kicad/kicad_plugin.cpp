@@ -41,6 +41,7 @@
 #include <zones.h>
 #include <plugins/kicad/kicad_plugin.h>
 #include <plugins/kicad/pcb_parser.h>
+#include <plugins/kicad/fp_cache_index.h>
 #include <pcbnew_settings.h>
 #include <boost/ptr_container/ptr_map.hpp>
 #include <convert_basic_shapes_to_polygon.h>    // for enum RECT_CHAMFER_POSITIONS definition
@@ -61,19 +62,49 @@ using namespace PCB_KEYS_T;
 class FP_CACHE_ITEM
 {
     WX_FILENAME                m_filename;
-    std::unique_ptr<FOOTPRINT> m_footprint;
+    FOOTPRINT_METADATA         m_metadata;
+    std::unique_ptr<FOOTPRINT> m_footprint;     // Only set once the footprint file is parsed.
+    bool                       m_parseFailed;   // The footprint file could not be parsed.
 
 public:
+    /// Create a fully loaded item.
     FP_CACHE_ITEM( FOOTPRINT* aFootprint, const WX_FILENAME& aFileName );
 
+    /// Create an item holding only the metadata of its footprint.  See FP_CACHE::GetFootprint().
+    FP_CACHE_ITEM( const FOOTPRINT_METADATA& aMetadata, const WX_FILENAME& aFileName );
+
     const WX_FILENAME& GetFileName() const { return m_filename; }
+    const FOOTPRINT_METADATA& GetMetadata() const { return m_metadata; }
+
+    bool IsLoaded() const { return m_footprint != nullptr; }
+
+    bool HasParseFailed() const { return m_parseFailed; }
+    void SetParseFailed() { m_parseFailed = true; }
+
+    /// @return the footprint if it has been parsed already, nullptr otherwise.
     const FOOTPRINT* GetFootprint()  const { return m_footprint.get(); }
+
+    void SetFootprint( FOOTPRINT* aFootprint ) { m_footprint.reset( aFootprint ); }
 };
 
 
 FP_CACHE_ITEM::FP_CACHE_ITEM( FOOTPRINT* aFootprint, const WX_FILENAME& aFileName ) :
         m_filename( aFileName ),
-        m_footprint( aFootprint )
+        m_footprint( aFootprint ),
+        m_parseFailed( false )
+{
+    m_metadata.m_Description = aFootprint->GetDescription();
+    m_metadata.m_Keywords = aFootprint->GetKeywords();
+    m_metadata.m_PadCount = aFootprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
+    m_metadata.m_UniquePadCount = aFootprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
+}
+
+
+FP_CACHE_ITEM::FP_CACHE_ITEM( const FOOTPRINT_METADATA& aMetadata,
+                              const WX_FILENAME& aFileName ) :
+        m_filename( aFileName ),
+        m_metadata( aMetadata ),
+        m_parseFailed( false )
 { }
 
 
@@ -86,6 +117,7 @@ class FP_CACHE
     wxFileName      m_lib_path;         // The path of the library.
     wxString        m_lib_raw_path;     // For quick comparisons.
     FOOTPRINT_MAP   m_footprints;       // Map of footprint filename to FOOTPRINT*.
+    FP_CACHE_INDEX  m_index;            // Metadata of the footprint files, kept on disk.
 
     bool            m_cache_dirty;      // Stored separately because it's expensive to check
                                         // m_cache_timestamp against all the files.
@@ -114,8 +146,25 @@ public:
      */
     void Save( FOOTPRINT* aFootprint = nullptr );
 
+    /**
+     * Enumerate the footprint files of the library.
+     *
+     * Footprints are not parsed here: each item only gets the metadata needed to list it,
+     * taken from the library index when the file is unchanged, or from a quick scan of the
+     * file otherwise.  See GetFootprint().
+     */
     void Load();
 
+    /**
+     * Return the footprint of \a aItem, parsing its file first if it was not loaded yet.
+     *
+     * A parse failure is recorded on the item and only reported once: later calls return
+     * nullptr until the library is modified and reloaded.
+     *
+     * @throw IO_ERROR if the footprint file cannot be parsed.
+     */
+    const FOOTPRINT* GetFootprint( FP_CACHE_ITEM& aItem );
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -145,7 +194,8 @@ public:
 };
 
 
-FP_CACHE::FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath )
+FP_CACHE::FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath ) :
+        m_index( aLibraryPath )
 {
     m_owner = aOwner;
     m_lib_raw_path = aLibraryPath;
@@ -178,6 +228,13 @@ void FP_CACHE::Save( FOOTPRINT* aFootprint )
 
         WX_FILENAME fn = it->second->GetFileName();
 
+        // Footprints which were never parsed cannot have been modified.
+        if( !it->second->IsLoaded() )
+        {
+            m_cache_timestamp += fn.GetTimestamp();
+            continue;
+        }
+
         wxString tempFileName =
 #ifdef USE_TMP_FILE
         wxFileName::CreateTempFileName( fn.GetPath() );
@@ -212,10 +269,13 @@ void FP_CACHE::Save( FOOTPRINT* aFootprint )
         }
 #endif
         m_cache_timestamp += fn.GetTimestamp();
+        m_index.Update( it->first, fn.GetFullName(), it->second->GetFootprint() );
     }
 
     m_cache_timestamp += m_lib_path.GetModificationTime().GetValue().GetValue();
 
+    m_index.Write();
+
     // If we've saved the full cache, we clear the dirty flag.
     if( !aFootprint )
         m_cache_dirty = false;
@@ -244,26 +304,42 @@ void FP_CACHE::Load()
     // the filename thereafter.
     WX_FILENAME fn( m_lib_raw_path, wxT( "dummyName" ) );
 
+    // A missing or stale index is not an error; it is simply rebuilt below.
+    m_index.Read();
+
+    std::set<wxString> indexed;
+    bool               indexChanged = false;
+    wxString           cacheError;
+
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
+            // Queue I/O errors so only files that fail to scan don't get loaded.
             try
             {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+                wxString                    fpName = fn.GetName();
+                const FP_CACHE_INDEX_ENTRY* entry = m_index.Find( fpName );
+                long long                   timestamp = 0;
+                long long                   size = 0;
 
-                m_owner->m_parser->SetLineReader( &reader );
+                FP_CACHE_INDEX::StatFile( fn.GetFullPath(), timestamp, size );
 
-                FOOTPRINT* footprint = (FOOTPRINT*) m_owner->m_parser->Parse();
-                wxString   fpName = fn.GetName();
+                if( !entry || entry->m_FileName != fullName || entry->m_Timestamp != timestamp
+                        || entry->m_Size != size )
+                {
+                    FP_CACHE_INDEX_ENTRY scanned;
+
+                    FP_CACHE_INDEX::ScanFile( m_lib_raw_path, fullName, scanned );
+                    m_index.Update( fpName, scanned );
+                    entry = m_index.Find( fpName );
+                    indexChanged = true;
+                }
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_footprints.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+                m_footprints.insert( fpName, new FP_CACHE_ITEM( entry->m_Metadata, fn ) );
+                indexed.insert( fpName );
 
                 m_cache_timestamp += fn.GetTimestamp();
             }
@@ -275,10 +351,54 @@ void FP_CACHE::Load()
                 cacheError += ioe.What();
             }
         } while( dir.GetNext( &fullName ) );
+    }
+
+    // Forget about footprint files which have been removed.
+    for( auto it = m_index.GetEntries().begin(); it != m_index.GetEntries().end(); )
+    {
+        wxString fpName = ( it++ )->first;
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+        if( !indexed.count( fpName ) )
+        {
+            m_index.Remove( fpName );
+            indexChanged = true;
+        }
     }
+
+    if( indexChanged )
+        m_index.Write();
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
+}
+
+
+const FOOTPRINT* FP_CACHE::GetFootprint( FP_CACHE_ITEM& aItem )
+{
+    if( aItem.IsLoaded() || aItem.HasParseFailed() )
+        return aItem.GetFootprint();
+
+    WX_FILENAME fn = aItem.GetFileName();
+    FOOTPRINT*  footprint = nullptr;
+
+    try
+    {
+        FILE_LINE_READER reader( fn.GetFullPath() );
+
+        m_owner->m_parser->SetLineReader( &reader );
+
+        footprint = (FOOTPRINT*) m_owner->m_parser->Parse();
+    }
+    catch( const IO_ERROR& )
+    {
+        aItem.SetParseFailed();
+        throw;
+    }
+
+    footprint->SetFPID( LIB_ID( wxEmptyString, fn.GetName() ) );
+    aItem.SetFootprint( footprint );
+
+    return footprint;
 }
 
 
@@ -298,6 +418,9 @@ void FP_CACHE::Remove( const wxString& aFootprintName )
     wxString fullPath = it->second->GetFileName().GetFullPath();
     m_footprints.erase( aFootprintName );
     wxRemoveFile( fullPath );
+
+    m_index.Remove( aFootprintName );
+    m_index.Write();
 }
 
 
@@ -2244,12 +2367,12 @@ const FOOTPRINT* PCB_IO::getFootprint( const wxString& aLibraryPath,
     }
 
     FOOTPRINT_MAP& footprints = m_cache->GetFootprints();
-    FOOTPRINT_MAP::const_iterator it = footprints.find( aFootprintName );
+    FOOTPRINT_MAP::iterator it = footprints.find( aFootprintName );
 
     if( it == footprints.end() )
         return nullptr;
 
-    return it->second->GetFootprint();
+    return m_cache->GetFootprint( *it->second );
 }
 
 
@@ -2261,6 +2384,33 @@ const FOOTPRINT* PCB_IO::GetEnumeratedFootprint( const wxString& aLibraryPath,
 }
 
 
+bool PCB_IO::GetFootprintMetadata( const wxString& aLibraryPath, const wxString& aFootprintName,
+                                   FOOTPRINT_METADATA& aMetadata, const PROPERTIES* aProperties )
+{
+    init( aProperties );
+
+    try
+    {
+        validateCache( aLibraryPath, false );
+    }
+    catch( const IO_ERROR& )
+    {
+        // do nothing with the error
+    }
+
+    FOOTPRINT_MAP&                footprints = m_cache->GetFootprints();
+    FOOTPRINT_MAP::const_iterator it = footprints.find( aFootprintName );
+
+    if( it == footprints.end() )
+        return false;
+
+    // This comes from the library index or a quick scan of the file; the footprint itself
+    // is not parsed.
+    aMetadata = it->second->GetMetadata();
+    return true;
+}
+
+
 bool PCB_IO::FootprintExists( const wxString& aLibraryPath, const wxString& aFootprintName,
                               const PROPERTIES* aProperties )
 {
@@ -2280,6 +2430,7 @@ bool PCB_IO::FootprintExists( const wxString& aLibraryPath, const wxString& aFoo
 FOOTPRINT* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFootprintName,
                                   const PROPERTIES* aProperties )
 {
+    // The cache parses the footprint file on first use, see FP_CACHE::GetFootprint()
     const FOOTPRINT* footprint = getFootprint( aLibraryPath, aFootprintName, aProperties, true );
 
     if( footprint )
@@ -164,6 +164,10 @@ public:
     bool FootprintExists( const wxString& aLibraryPath, const wxString& aFootprintName,
                           const PROPERTIES* aProperties = nullptr ) override;
 
+    bool GetFootprintMetadata( const wxString& aLibraryPath, const wxString& aFootprintName,
+                               FOOTPRINT_METADATA& aMetadata,
+                               const PROPERTIES* aProperties = nullptr ) override;
+
     FOOTPRINT* FootprintLoad( const wxString& aLibraryPath, const wxString& aFootprintName,
                               const PROPERTIES* aProperties = nullptr ) override;
 
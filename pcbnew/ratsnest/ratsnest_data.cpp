@@ -40,6 +40,7 @@ using namespace std::placeholders;
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <limits>
 
 #include <delaunator.hpp>
@@ -106,13 +107,14 @@ private:
     std::vector<int> m_depth;
 };
 
-void RN_NET::kruskalMST( const std::vector<CN_EDGE> &aEdges )
+bool RN_NET::kruskalMST( const std::vector<CN_EDGE> &aEdges )
 {
     disjoint_set dset( m_nodes.size() );
 
     m_rnEdges.clear();
 
-    int i = 0;
+    int    i = 0;
+    size_t unions = 0;
 
     for( auto& node : m_nodes )
         node->SetTag( i++ );
@@ -124,10 +126,92 @@ void RN_NET::kruskalMST( const std::vector<CN_EDGE> &aEdges )
 
         if( dset.unite( u, v ) )
         {
+            unions++;
+
             if( tmp.GetWeight() > 0 )
                 m_rnEdges.push_back( tmp );
         }
     }
+
+    return unions + 1 >= m_nodes.size();
+}
+
+
+/**
+ * Return a positive value if \a aP lies inside the circumcircle of the triangle \a aA,
+ * \a aB, \a aC (in any orientation), a negative value if it lies outside, and in
+ * \a aError the bound of the rounding error of the result.
+ */
+static double inCircumcircle( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aC,
+                              const VECTOR2I& aP, double& aError )
+{
+    double adx = (double) aA.x - aP.x;
+    double ady = (double) aA.y - aP.y;
+    double bdx = (double) aB.x - aP.x;
+    double bdy = (double) aB.y - aP.y;
+    double cdx = (double) aC.x - aP.x;
+    double cdy = (double) aC.y - aP.y;
+
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * ( bdx * cdy - bdy * cdx )
+               + blift * ( cdx * ady - cdy * adx )
+               + clift * ( adx * bdy - ady * bdx );
+
+    double permanent = alift * ( std::abs( bdx * cdy ) + std::abs( bdy * cdx ) )
+                     + blift * ( std::abs( cdx * ady ) + std::abs( cdy * adx ) )
+                     + clift * ( std::abs( adx * bdy ) + std::abs( ady * bdx ) );
+
+    double orientation = ( (double) aB.x - aA.x ) * ( (double) aC.y - aA.y )
+                       - ( (double) aB.y - aA.y ) * ( (double) aC.x - aA.x );
+
+    aError = permanent * 1e-14;
+
+    return orientation > 0 ? det : -det;
+}
+
+
+/**
+ * Return the convex hull of \a aPoints, which must be sorted by x then y, as a closed
+ * counterclockwise (in a y-up frame) list of indices.  Points lying on the hull edges are
+ * kept.
+ */
+static std::vector<size_t> convexHull( const std::vector<VECTOR2I>& aPoints )
+{
+    auto cross =
+            []( const VECTOR2I& o, const VECTOR2I& a, const VECTOR2I& b ) -> double
+            {
+                return ( (double) a.x - o.x ) * ( (double) b.y - o.y )
+                     - ( (double) a.y - o.y ) * ( (double) b.x - o.x );
+            };
+
+    std::vector<size_t> hull( 2 * aPoints.size() );
+    size_t              k = 0;
+
+    // Andrew's monotone chain: lower hull, then upper hull
+    for( size_t i = 0; i < aPoints.size(); i++ )
+    {
+        while( k >= 2 && cross( aPoints[hull[k - 2]], aPoints[hull[k - 1]], aPoints[i] ) < 0 )
+            k--;
+
+        hull[k++] = i;
+    }
+
+    for( size_t i = aPoints.size() - 1, lower = k + 1; i > 0; i-- )
+    {
+        while( k >= lower
+                && cross( aPoints[hull[k - 2]], aPoints[hull[k - 1]], aPoints[i - 1] ) < 0 )
+        {
+            k--;
+        }
+
+        hull[k++] = i - 1;
+    }
+
+    hull.resize( k );
+    return hull;
 }
 
 
@@ -136,20 +220,31 @@ class RN_NET::TRIANGULATOR_STATE
 private:
     std::multiset<CN_ANCHOR_PTR, CN_PTR_CMP> m_allNodes;
 
+    ///< Unique node positions of the last triangulation, in m_allNodes order.
+    std::vector<VECTOR2I> m_points;
+
+    ///< Triangles of the last triangulation as triples of indices into m_points.  This is a
+    ///< superset of the Delaunay triangulation of m_points (see updateTriangles()).
+    std::vector<size_t> m_triangles;
 
-    // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
-    // have unique coordinates!
-    bool areNodesColinear( const std::vector<CN_ANCHOR_PTR>& aNodes ) const
+    static bool pointLess( const VECTOR2I& aA, const VECTOR2I& aB )
     {
-        if ( aNodes.size() <= 2 )
+        return aA.x < aB.x || ( aA.x == aB.x && aA.y < aB.y );
+    }
+
+    // Checks if all points lie on a single line. Requires the points to have unique
+    // coordinates!
+    static bool arePointsColinear( const std::vector<VECTOR2I>& aPoints )
+    {
+        if ( aPoints.size() <= 2 )
             return true;
 
-        const VECTOR2I p0( aNodes[0]->Pos() );
-        const VECTOR2I v0( aNodes[1]->Pos() - p0 );
+        const VECTOR2I p0( aPoints[0] );
+        const VECTOR2I v0( aPoints[1] - p0 );
 
-        for( unsigned i = 2; i < aNodes.size(); i++ )
+        for( unsigned i = 2; i < aPoints.size(); i++ )
         {
-            const VECTOR2I v1 = aNodes[i]->Pos() - p0;
+            const VECTOR2I v1 = aPoints[i] - p0;
 
             if( v0.Cross( v1 ) != 0 )
                 return false;
@@ -158,6 +253,233 @@ private:
         return true;
     }
 
+    static void delaunayTriangles( const std::vector<VECTOR2I>& aPoints,
+                                   std::vector<size_t>& aTriangles )
+    {
+        std::vector<double> node_pts;
+
+        node_pts.reserve( 2 * aPoints.size() );
+
+        for( const VECTOR2I& pt : aPoints )
+        {
+            node_pts.push_back( pt.x );
+            node_pts.push_back( pt.y );
+        }
+
+        delaunator::Delaunator delaunator( node_pts );
+        aTriangles = std::move( delaunator.triangles );
+    }
+
+    /**
+     * Update m_triangles for the new node positions \a aPoints by re-triangulating only the
+     * region around the positions that were added or removed since the last call.
+     *
+     * The triangles whose circumcircle contains an added point, or which use a removed point,
+     * are the only ones that can disappear from the Delaunay triangulation; the triangles that
+     * replace them only use the vertices of these triangles, the added points and the hull
+     * vertices visible from the added points.  Those are re-triangulated together and the new
+     * triangles which are clearly not Delaunay are discarded.  The result always contains the
+     * Delaunay triangulation, and therefore the minimum spanning tree.
+     *
+     * @return false if the change is too large to be worth it, and the caller should
+     *         triangulate from scratch.
+     */
+    bool updateTriangles( const std::vector<VECTOR2I>& aPoints )
+    {
+        if( m_triangles.empty() )
+            return false;
+
+        std::vector<int>    oldToNew( m_points.size(), -1 );
+        std::vector<size_t> added;
+        size_t              removed = 0;
+        size_t              i = 0;
+        size_t              j = 0;
+
+        while( i < m_points.size() || j < aPoints.size() )
+        {
+            if( j == aPoints.size() || ( i < m_points.size()
+                                         && pointLess( m_points[i], aPoints[j] ) ) )
+            {
+                removed++;
+                i++;
+            }
+            else if( i == m_points.size() || pointLess( aPoints[j], m_points[i] ) )
+            {
+                added.push_back( j++ );
+            }
+            else
+            {
+                oldToNew[i++] = j++;
+            }
+        }
+
+        if( removed == 0 && added.empty() )
+            return true;
+
+        // Each added point is tested against every triangle, so past a few hundred changes a
+        // fresh triangulation is cheaper
+        if( ( removed + added.size() ) * 8 > aPoints.size() || added.size() > 256 )
+            return false;
+
+        std::vector<bool>   inRegion( aPoints.size(), false );
+        std::vector<size_t> triangles;
+
+        triangles.reserve( m_triangles.size() + 12 * added.size() );
+
+        for( i = 0; i < m_triangles.size(); i += 3 )
+        {
+            int  a = oldToNew[m_triangles[i]];
+            int  b = oldToNew[m_triangles[i + 1]];
+            int  c = oldToNew[m_triangles[i + 2]];
+            bool affected = a < 0 || b < 0 || c < 0;
+
+            for( size_t k = 0; k < added.size() && !affected; k++ )
+            {
+                double error;
+                double inside = inCircumcircle( aPoints[a], aPoints[b], aPoints[c],
+                                                aPoints[added[k]], error );
+
+                affected = inside >= -error;
+            }
+
+            if( affected )
+            {
+                for( int v : { a, b, c } )
+                {
+                    if( v >= 0 )
+                        inRegion[v] = true;
+                }
+            }
+            else
+            {
+                triangles.push_back( a );
+                triangles.push_back( b );
+                triangles.push_back( c );
+            }
+        }
+
+        // Points added outside of the hull connect to the hull vertices they can see
+        std::vector<size_t> hull = convexHull( m_points );
+
+        for( size_t pt : added )
+        {
+            inRegion[pt] = true;
+
+            for( size_t k = 0; k < hull.size(); k++ )
+            {
+                const VECTOR2I& h0 = m_points[hull[k]];
+                const VECTOR2I& h1 = m_points[hull[( k + 1 ) % hull.size()]];
+                const VECTOR2I& p = aPoints[pt];
+
+                double ex = (double) h1.x - h0.x;
+                double ey = (double) h1.y - h0.y;
+                double px = (double) p.x - h0.x;
+                double py = (double) p.y - h0.y;
+                double side = ex * py - ey * px;
+                double error = ( std::abs( ex * py ) + std::abs( ey * px ) ) * 1e-14;
+
+                if( side <= error )
+                {
+                    for( size_t v : { hull[k], hull[( k + 1 ) % hull.size()] } )
+                    {
+                        if( oldToNew[v] >= 0 )
+                            inRegion[oldToNew[v]] = true;
+                    }
+                }
+            }
+        }
+
+        std::vector<size_t>   regionToNew;
+        std::vector<VECTOR2I> regionPoints;
+
+        for( i = 0; i < aPoints.size(); i++ )
+        {
+            if( inRegion[i] )
+            {
+                regionToNew.push_back( i );
+                regionPoints.push_back( aPoints[i] );
+            }
+        }
+
+        if( arePointsColinear( regionPoints ) )
+            return false;
+
+        std::vector<size_t> regionTriangles;
+        delaunayTriangles( regionPoints, regionTriangles );
+
+        for( i = 0; i < regionTriangles.size(); i += 3 )
+        {
+            size_t a = regionToNew[regionTriangles[i]];
+            size_t b = regionToNew[regionTriangles[i + 1]];
+            size_t c = regionToNew[regionTriangles[i + 2]];
+
+            if( !isClearlyNotDelaunay( aPoints, a, b, c ) )
+            {
+                triangles.push_back( a );
+                triangles.push_back( b );
+                triangles.push_back( c );
+            }
+        }
+
+        // Triangles kept by a too lenient test pile up; start over when there are too many
+        if( triangles.size() > 3 * 3 * aPoints.size() )
+            return false;
+
+        m_triangles = std::move( triangles );
+        return true;
+    }
+
+    /**
+     * @return true if one of \a aPoints lies strictly inside the circumcircle of the triangle
+     *         \a aA, \a aB, \a aC.  The points are sorted by x, so only the ones in the x range
+     *         of the circle need to be checked.
+     */
+    static bool isClearlyNotDelaunay( const std::vector<VECTOR2I>& aPoints, size_t aA,
+                                      size_t aB, size_t aC )
+    {
+        const VECTOR2I& a = aPoints[aA];
+        const VECTOR2I& b = aPoints[aB];
+        const VECTOR2I& c = aPoints[aC];
+
+        // Circumcenter, relative to a
+        double bx = (double) b.x - a.x;
+        double by = (double) b.y - a.y;
+        double cx = (double) c.x - a.x;
+        double cy = (double) c.y - a.y;
+        double d = 2.0 * ( bx * cy - by * cx );
+
+        if( d == 0.0 )
+            return false;
+
+        double bSq = bx * bx + by * by;
+        double cSq = cx * cx + cy * cy;
+        double ux = ( cy * bSq - by * cSq ) / d;
+        double uy = ( bx * cSq - cx * bSq ) / d;
+        double r = std::hypot( ux, uy );
+        double centerX = a.x + ux;
+
+        auto first = std::lower_bound( aPoints.begin(), aPoints.end(), centerX - r - 1,
+                                       []( const VECTOR2I& aPt, double aX )
+                                       {
+                                           return aPt.x < aX;
+                                       } );
+
+        for( auto it = first; it != aPoints.end() && it->x <= centerX + r + 1; ++it )
+        {
+            size_t idx = it - aPoints.begin();
+
+            if( idx == aA || idx == aB || idx == aC )
+                continue;
+
+            double error;
+
+            if( inCircumcircle( a, b, c, *it, error ) > error )
+                return true;
+        }
+
+        return false;
+    }
+
 public:
 
     void Clear()
@@ -170,17 +492,23 @@ public:
         m_allNodes.insert( aNode );
     }
 
-    void Triangulate( std::vector<CN_EDGE>& mstEdges)
+    /**
+     * Add to \a mstEdges the edges of the triangulation of the nodes.
+     *
+     * @param aIncremental allows reusing the triangles of the previous call.
+     * @return true if the triangles of the previous call were reused.
+     */
+    bool Triangulate( std::vector<CN_EDGE>& mstEdges, bool aIncremental )
     {
-        std::vector<double>          node_pts;
-
         using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
 
         ANCHOR_LIST              anchors;
+        std::vector<VECTOR2I>    points;
         std::vector<ANCHOR_LIST> anchorChains( m_allNodes.size() );
+        bool                     reused = false;
 
-        node_pts.reserve( 2 * m_allNodes.size() );
         anchors.reserve( m_allNodes.size() );
+        points.reserve( m_allNodes.size() );
 
         CN_ANCHOR_PTR prev = nullptr;
 
@@ -188,8 +516,7 @@ public:
         {
             if( !prev || prev->Pos() != n->Pos() )
             {
-                node_pts.push_back( n->Pos().x );
-                node_pts.push_back( n->Pos().y );
+                points.push_back( n->Pos() );
                 anchors.push_back( n );
                 prev = n;
             }
@@ -199,9 +526,11 @@ public:
 
         if( anchors.size() < 2 )
         {
-            return;
+            m_points.clear();
+            m_triangles.clear();
+            return false;
         }
-        else if( areNodesColinear( anchors ) )
+        else if( arePointsColinear( points ) )
         {
             // special case: all nodes are on the same line - there's no
             // triangulation for such set. In this case, we sort along any coordinate
@@ -212,38 +541,34 @@ public:
                 auto dst = anchors[i + 1];
                 mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
             }
+
+            m_triangles.clear();
         }
         else
         {
-            delaunator::Delaunator delaunator( node_pts );
-            auto& triangles = delaunator.triangles;
+            reused = aIncremental && updateTriangles( points );
 
-            for( size_t i = 0; i < triangles.size(); i += 3 )
-            {
-                auto src = anchors[triangles[i]];
-                auto dst = anchors[triangles[i + 1]];
-                mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
+            if( !reused )
+                delaunayTriangles( points, m_triangles );
 
-                src = anchors[triangles[i + 1]];
-                dst = anchors[triangles[i + 2]];
+            for( size_t i = 0; i < m_triangles.size(); i += 3 )
+            {
+                auto src = anchors[m_triangles[i]];
+                auto dst = anchors[m_triangles[i + 1]];
                 mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
 
-                src = anchors[triangles[i + 2]];
-                dst = anchors[triangles[i]];
+                src = anchors[m_triangles[i + 1]];
+                dst = anchors[m_triangles[i + 2]];
                 mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
-            }
-
-            for( size_t i = 0; i < delaunator.halfedges.size(); i++ )
-            {
-                if( delaunator.halfedges[i] == delaunator::INVALID_INDEX )
-                    continue;
 
-                auto src = anchors[triangles[i]];
-                auto dst = anchors[triangles[delaunator.halfedges[i]]];
+                src = anchors[m_triangles[i + 2]];
+                dst = anchors[m_triangles[i]];
                 mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
             }
         }
 
+        m_points = std::move( points );
+
         for( size_t i = 0; i < anchorChains.size(); i++ )
         {
             auto& chain = anchorChains[i];
@@ -264,6 +589,8 @@ public:
                 mstEdges.emplace_back( prevNode, curNode, weight );
             }
         }
+
+        return reused;
     }
 };
 
@@ -312,30 +639,37 @@ void RN_NET::compute()
         m_triangulator->AddNode( n );
     }
 
-    std::vector<CN_EDGE> triangEdges;
-    triangEdges.reserve( m_nodes.size() + m_boardEdges.size() );
+    for( bool incremental : { true, false } )
+    {
+        std::vector<CN_EDGE> triangEdges;
+        triangEdges.reserve( m_nodes.size() + m_boardEdges.size() );
 
-    #ifdef PROFILE
-    PROF_COUNTER cnt("triangulate");
-    #endif
-    m_triangulator->Triangulate( triangEdges );
-    #ifdef PROFILE
-    cnt.Show();
-    #endif
+#ifdef PROFILE
+        PROF_COUNTER cnt("triangulate");
+#endif
+        bool reused = m_triangulator->Triangulate( triangEdges, incremental );
+#ifdef PROFILE
+        cnt.Show();
+#endif
 
-    for( const auto& e : m_boardEdges )
-        triangEdges.emplace_back( e );
+        for( const auto& e : m_boardEdges )
+            triangEdges.emplace_back( e );
 
-    std::sort( triangEdges.begin(), triangEdges.end() );
+        std::sort( triangEdges.begin(), triangEdges.end() );
 
-// Get the minimal spanning tree
+        // Get the minimal spanning tree
 #ifdef PROFILE
-    PROF_COUNTER cnt2("mst");
+        PROF_COUNTER cnt2("mst");
 #endif
-    kruskalMST( triangEdges );
+        bool connected = kruskalMST( triangEdges );
 #ifdef PROFILE
-    cnt2.Show();
+        cnt2.Show();
 #endif
+
+        // The reused triangles are only a safety net away from a full triangulation
+        if( connected || !reused )
+            break;
+    }
 }
 
 
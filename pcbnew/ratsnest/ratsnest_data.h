@@ -95,7 +95,7 @@ public:
      *
      * @return Pointer to a vector of edges that makes ratsnest for a given net.
      */
-    const std::vector<CN_EDGE> GetUnconnected() const
+    const std::vector<CN_EDGE>& GetUnconnected() const
     {
         return m_rnEdges;
     }
@@ -145,11 +145,12 @@ public:
                                CN_ANCHOR_PTR& aNode2 ) const;
 
 protected:
-    ///< Recompute ratsnest from scratch.
+    ///< Recompute ratsnest, re-triangulating only around the nodes that moved.
     void compute();
 
-    ///< Compute the minimum spanning tree using Kruskal's algorithm
-    void kruskalMST( const std::vector<CN_EDGE> &aEdges );
+    ///< Compute the minimum spanning tree using Kruskal's algorithm.  Return false if the
+    ///< edges left some nodes unconnected.
+    bool kruskalMST( const std::vector<CN_EDGE> &aEdges );
 
     ///< Vector of nodes
     std::multiset<CN_ANCHOR_PTR, CN_PTR_CMP> m_nodes;
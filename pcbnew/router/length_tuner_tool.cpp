@@ -33,6 +33,7 @@
 #include <tool/action_menu.h>
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
+#include <tools/pcb_selection_tool.h>
 #include "pns_segment.h"
 #include "pns_router.h"
 #include "pns_meander_placer.h" // fixme: move settings to separate header
@@ -267,6 +268,8 @@ void LENGTH_TUNER_TOOL::setTransitions()
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneSingleTrace.MakeEvent() );
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneDiffPair.MakeEvent() );
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneDiffPairSkew.MakeEvent() );
+    Go( &LENGTH_TUNER_TOOL::TuneSelection, PCB_ACTIONS::routerTuneSelectedTracks.MakeEvent() );
+    Go( &LENGTH_TUNER_TOOL::TuneSelection, PCB_ACTIONS::routerTuneSelectedDiffPairs.MakeEvent() );
 }
 
 
@@ -333,6 +336,53 @@ int LENGTH_TUNER_TOOL::MainLoop( const TOOL_EVENT& aEvent )
     return 0;
 }
 
+int LENGTH_TUNER_TOOL::TuneSelection( const TOOL_EVENT& aEvent )
+{
+    PNS::ROUTER_MODE     mode = aEvent.Parameter<PNS::ROUTER_MODE>();
+    const PCB_SELECTION& selection = m_toolMgr->GetTool<PCB_SELECTION_TOOL>()->GetSelection();
+    std::vector<BOARD_ITEM*> tracks;
+
+    for( EDA_ITEM* item : selection )
+    {
+        if( item->Type() == PCB_TRACE_T || item->Type() == PCB_ARC_T )
+            tracks.push_back( static_cast<BOARD_ITEM*>( item ) );
+    }
+
+    if( tracks.empty() )
+    {
+        frame()->ShowInfoBarMsg( _( "Select the tracks whose lengths you want to tune." ) );
+        return 0;
+    }
+
+    DIALOG_PNS_LENGTH_TUNING_SETTINGS settingsDlg( frame(), m_savedMeanderSettings, mode );
+
+    if( settingsDlg.ShowModal() != wxID_OK )
+        return 0;
+
+    // The tuned tracks are replaced
+    m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+
+    syncWorld();
+
+    // The placers take their sizes from the router, as in interactive tuning
+    m_router->UpdateSizes( m_savedSizes );
+
+    std::vector<PNS::ITEM*> items;
+
+    for( BOARD_ITEM* track : tracks )
+    {
+        if( PNS::ITEM* item = m_router->GetWorld()->FindItemByParent( track ) )
+            items.push_back( item );
+    }
+
+    int tuned = m_router->TuneLengths( items, mode, m_savedMeanderSettings );
+
+    frame()->ShowInfoBarMsg( wxString::Format( _( "%d tracks tuned to the target length." ),
+                                               tuned ) );
+    return 0;
+}
+
+
 int LENGTH_TUNER_TOOL::meanderSettingsDialog( const TOOL_EVENT& aEvent )
 {
     PNS::MEANDER_PLACER_BASE* placer = static_cast<PNS::MEANDER_PLACER_BASE*>( m_router->Placer() );
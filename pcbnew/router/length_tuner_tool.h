@@ -41,6 +41,9 @@ public:
 
     int MainLoop( const TOOL_EVENT& aEvent );
 
+    ///< Tune the lengths of the selected tracks or differential pairs to a common target.
+    int TuneSelection( const TOOL_EVENT& aEvent );
+
     void setTransitions() override;
 
 private:
@@ -54,6 +54,15 @@ DP_MEANDER_PLACER::~DP_MEANDER_PLACER()
 }
 
 
+void DP_MEANDER_PLACER::ReleaseBranches()
+{
+    // Freed with the other children of m_world
+    m_currentNode = nullptr;
+
+    MEANDER_PLACER_BASE::ReleaseBranches();
+}
+
+
 const LINE DP_MEANDER_PLACER::Trace() const
 {
     return m_currentTraceP;
@@ -81,7 +90,7 @@ bool DP_MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_currentNode    = nullptr;
     m_currentStart   = getSnappedStartPoint( m_initialSegment, aP );
 
-    m_world = Router()->GetWorld()->Branch();
+    m_world = baseNode()->Branch();
 
     TOPOLOGY topo( m_world );
 
@@ -105,6 +105,8 @@ public:
 
     bool CheckFit( MEANDER_SHAPE* aShape ) override;
 
+    void ReleaseBranches() override;
+
 
 private:
     friend class MEANDER_SHAPE;
@@ -0,0 +1,110 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_HULL_CACHE_H
+#define __PNS_HULL_CACHE_H
+
+#include <mutex>
+#include <vector>
+
+#include <geometry/shape_line_chain.h>
+
+namespace PNS {
+
+/**
+ * Hulls of an item, by clearance.
+ *
+ * Walkaround asks for the hulls of the same obstacles with the same few clearances over and
+ * over.  The owning item keeps them here and must Clear() them whenever its geometry changes.
+ * Lookups may come from parallel collision queries.
+ */
+class HULL_CACHE
+{
+public:
+    HULL_CACHE() = default;
+
+    /// Copies start empty, since the copied item is usually modified right away.
+    HULL_CACHE( const HULL_CACHE& ) {}
+
+    HULL_CACHE& operator=( const HULL_CACHE& )
+    {
+        Clear();
+        return *this;
+    }
+
+    /**
+     * @return the hull of the item (or of its hole if \a aHole is set) for the given clearance,
+     *         made by \a aBuild unless it is cached.
+     */
+    template <class BUILD>
+    const SHAPE_LINE_CHAIN Get( int aClearance, int aWalkaroundThickness, bool aHole,
+                                BUILD aBuild ) const
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+
+            for( const ENTRY& entry : m_entries )
+            {
+                if( entry.m_clearance == aClearance
+                        && entry.m_walkaroundThickness == aWalkaroundThickness
+                        && entry.m_hole == aHole )
+                {
+                    return entry.m_hull;
+                }
+            }
+        }
+
+        // Not under the lock: the hull may be expensive to build
+        SHAPE_LINE_CHAIN hull = aBuild();
+
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        if( m_entries.size() >= MAX_ENTRIES )
+            m_entries.erase( m_entries.begin() );
+
+        m_entries.push_back( { aClearance, aWalkaroundThickness, aHole, hull } );
+
+        return hull;
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_entries.clear();
+    }
+
+private:
+    ///< A few clearances are in use at a time; the oldest hull is dropped to make room
+    static constexpr size_t MAX_ENTRIES = 4;
+
+    struct ENTRY
+    {
+        int              m_clearance;
+        int              m_walkaroundThickness;
+        bool             m_hole;
+        SHAPE_LINE_CHAIN m_hull;
+    };
+
+    mutable std::mutex         m_mutex;
+    mutable std::vector<ENTRY> m_entries;
+};
+
+}
+
+#endif    // __PNS_HULL_CACHE_H
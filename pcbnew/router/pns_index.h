@@ -22,6 +22,7 @@
 #ifndef __PNS_INDEX_H
 #define __PNS_INDEX_H
 
+#include <algorithm>
 #include <deque>
 #include <list>
 #include <map>
@@ -51,6 +52,18 @@ public:
 
     INDEX(){};
 
+    /**
+     * Copy the items of another index.  The shape indices own their trees, so the items are
+     * added again rather than copied.
+     */
+    INDEX( const INDEX& aOther )
+    {
+        for( ITEM* item : aOther.m_allItems )
+            Add( item );
+    }
+
+    INDEX& operator=( const INDEX& ) = delete;
+
     /**
      * Adds item to the spatial index.
      */
@@ -94,6 +107,22 @@ public:
     template<class Visitor>
     int Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
 
+    /**
+     * Searches items in the index that are in proximity of any of aBoxes, walking
+     * the tree of each layer once.  Only items on overlapping layers are considered.
+     *
+     * @param aBoxes areas to search against, e.g. the bounding boxes of the
+     *               segments of a line
+     * @param aLayers layers to search on
+     * @param aMinDistance proximity distance (wrs to the boxes)
+     * @param aVisitor function object called on each found item, once per layer.
+              Return false from the visitor to stop searching.
+     * @return number of items found.
+     */
+    template<class Visitor>
+    int Query( const std::vector<BOX2I>& aBoxes, const LAYER_RANGE& aLayers, int aMinDistance,
+               Visitor& aVisitor ) const;
+
     /**
      * Returns list of all items in a given net.
      */
@@ -161,6 +190,19 @@ int INDEX::Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) con
     return total;
 }
 
+template<class Visitor>
+int INDEX::Query( const std::vector<BOX2I>& aBoxes, const LAYER_RANGE& aLayers, int aMinDistance,
+                  Visitor& aVisitor ) const
+{
+    int total = 0;
+
+    for( int i = std::max( aLayers.Start(), 0 );
+         i <= aLayers.End() && i < (int) m_subIndices.size(); ++i )
+        total += m_subIndices[i].Query( aBoxes, aMinDistance, aVisitor );
+
+    return total;
+}
+
 };
 
 #endif
@@ -60,13 +60,13 @@ bool ITEM::collideSimple( const ITEM* aOther, const NODE* aNode, bool aDifferent
 
         if( holeA && holeA->Collide( shapeB, holeClearance + lineWidthB ) )
         {
-            Mark( Marker() | MK_HOLE );
+            AddMarker( MK_HOLE );
             return true;
         }
 
         if( holeB && holeB->Collide( shapeA, holeClearance + lineWidthA ) )
         {
-            aOther->Mark( aOther->Marker() | MK_HOLE );
+            aOther->AddMarker( MK_HOLE );
             return true;
         }
 
@@ -76,8 +76,8 @@ bool ITEM::collideSimple( const ITEM* aOther, const NODE* aNode, bool aDifferent
 
             if( holeA->Collide( holeB, holeToHoleClearance ) )
             {
-                Mark( Marker() | MK_HOLE );
-                aOther->Mark( aOther->Marker() | MK_HOLE );
+                AddMarker( MK_HOLE );
+                aOther->AddMarker( MK_HOLE );
                 return true;
             }
         }
@@ -23,6 +23,7 @@
 #ifndef __PNS_ITEM_H
 #define __PNS_ITEM_H
 
+#include <atomic>
 #include <memory>
 #include <math/vector2d.h>
 
@@ -90,11 +91,26 @@ public:
         m_kind = aOther.m_kind;
         m_parent = aOther.m_parent;
         m_owner = aOther.m_owner; // fixme: wtf this was null?
-        m_marker = aOther.m_marker;
+        m_marker = aOther.m_marker.load();
         m_rank = aOther.m_rank;
         m_routable = aOther.m_routable;
     }
 
+    ITEM& operator=( const ITEM& aOther )
+    {
+        m_layers = aOther.m_layers;
+        m_net = aOther.m_net;
+        m_movable = aOther.m_movable;
+        m_kind = aOther.m_kind;
+        m_parent = aOther.m_parent;
+        m_owner = aOther.m_owner;
+        m_marker = aOther.m_marker.load();
+        m_rank = aOther.m_rank;
+        m_routable = aOther.m_routable;
+
+        return *this;
+    }
+
     virtual ~ITEM();
 
     /**
@@ -204,6 +220,12 @@ public:
     }
 
     virtual void Mark( int aMarker ) const { m_marker = aMarker; }
+
+    /**
+     * Set the bits of \a aMarker, leaving the others alone.  Unlike Mark( Marker() | aMarker ),
+     * this is a single atomic operation, as collision queries may run in parallel.
+     */
+    virtual void AddMarker( int aMarker ) const { m_marker |= aMarker; }
     virtual void Unmark( int aMarker = -1 ) const { m_marker &= ~aMarker; }
     virtual int Marker() const { return m_marker; }
 
@@ -240,7 +262,7 @@ protected:
 
     bool          m_movable;
     int           m_net;
-    mutable int   m_marker;
+    mutable std::atomic<int> m_marker;    ///< Set by collision queries, which may run in parallel
     int           m_rank;
     bool          m_routable;
 };
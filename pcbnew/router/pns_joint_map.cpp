@@ -0,0 +1,203 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+
+#include "pns_joint_map.h"
+
+namespace PNS {
+
+
+JOINT_MAP::OBSERVER* JOINT_MAP::s_observer = nullptr;
+
+
+JOINT_MAP::JOINT_MAP() :
+        m_count( 0 )
+{
+    observe( OP::CREATE );
+}
+
+
+JOINT_MAP::JOINT_MAP( const JOINT_MAP& aOther ) :
+        m_slots( aOther.m_slots.size() ),
+        m_count( aOther.m_count )
+{
+    // Same size, same hashes: every joint goes to the same slot
+    for( size_t i = 0; i < m_slots.size(); i++ )
+    {
+        const SLOT& other = aOther.m_slots[i];
+
+        if( other.m_joint )
+        {
+            m_slots[i].m_hash = other.m_hash;
+            m_slots[i].m_joint = std::make_unique<JOINT>( *other.m_joint );
+        }
+    }
+
+    observe( OP::CREATE, JOINT::HASH_TAG(), LAYER_RANGE(), &aOther );
+}
+
+
+JOINT_MAP::~JOINT_MAP()
+{
+    observe( OP::DESTROY );
+}
+
+
+size_t JOINT_MAP::HashTag( const JOINT::HASH_TAG& aTag )
+{
+    // Board coordinates are often multiples of a grid, so mix all the bits; the table
+    // index is taken from the low ones.
+    uint64_t h = static_cast<uint32_t>( aTag.pos.x ) * 0x9E3779B97F4A7C15ULL;
+
+    h ^= static_cast<uint32_t>( aTag.pos.y ) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= static_cast<uint32_t>( aTag.net ) * 0x165667B19E3779F9ULL;
+    h ^= h >> 32;
+
+    return static_cast<size_t>( h );
+}
+
+
+JOINT* JOINT_MAP::Find( const JOINT::HASH_TAG& aTag, int aLayer ) const
+{
+    JOINT* found = nullptr;
+
+    observe( OP::FIND, aTag, LAYER_RANGE( aLayer ) );
+
+    forEach( aTag,
+             [&]( JOINT& aJoint )
+             {
+                 if( !found && aJoint.Layers().Overlaps( aLayer ) )
+                     found = &aJoint;
+             } );
+
+    return found;
+}
+
+
+bool JOINT_MAP::Contains( const JOINT::HASH_TAG& aTag ) const
+{
+    bool found = false;
+
+    observe( OP::CONTAINS, aTag );
+
+    forEach( aTag,
+             [&]( JOINT& )
+             {
+                 found = true;
+             } );
+
+    return found;
+}
+
+
+JOINT& JOINT_MAP::Insert( std::unique_ptr<JOINT> aJoint )
+{
+    observe( OP::INSERT, aJoint->Tag(), aJoint->Layers() );
+
+    // Keep at least half of the slots empty, so that probe sequences stay short
+    if( 2 * ( m_count + 1 ) > m_slots.size() )
+        grow();
+
+    size_t hash = HashTag( aJoint->Tag() );
+    size_t i = hash & mask();
+
+    while( m_slots[i].m_joint )
+        i = ( i + 1 ) & mask();
+
+    m_slots[i].m_hash = hash;
+    m_slots[i].m_joint = std::move( aJoint );
+    m_count++;
+
+    return *m_slots[i].m_joint;
+}
+
+
+std::unique_ptr<JOINT> JOINT_MAP::Take( const JOINT::HASH_TAG& aTag, const LAYER_RANGE& aLayers )
+{
+    observe( OP::TAKE, aTag, aLayers );
+
+    if( m_slots.empty() )
+        return nullptr;
+
+    size_t hash = HashTag( aTag );
+
+    for( size_t i = hash & mask(); m_slots[i].m_joint; i = ( i + 1 ) & mask() )
+    {
+        SLOT& slot = m_slots[i];
+
+        if( slot.m_hash == hash && slot.m_joint->Tag() == aTag
+                && aLayers.Overlaps( slot.m_joint->Layers() ) )
+        {
+            std::unique_ptr<JOINT> joint = std::move( slot.m_joint );
+
+            removeSlot( i );
+            return joint;
+        }
+    }
+
+    return nullptr;
+}
+
+
+void JOINT_MAP::grow()
+{
+    std::vector<SLOT> old;
+
+    old.swap( m_slots );
+    m_slots.resize( old.empty() ? 16 : 2 * old.size() );
+
+    for( SLOT& slot : old )
+    {
+        if( !slot.m_joint )
+            continue;
+
+        size_t i = slot.m_hash & mask();
+
+        while( m_slots[i].m_joint )
+            i = ( i + 1 ) & mask();
+
+        m_slots[i] = std::move( slot );
+    }
+}
+
+
+void JOINT_MAP::removeSlot( size_t aIndex )
+{
+    // Shift the following entries of the probe sequence back, so that no lookup stops at the
+    // hole.  An entry stays put if its home slot lies between the hole and itself.
+    size_t hole = aIndex;
+
+    for( size_t i = ( hole + 1 ) & mask(); m_slots[i].m_joint; i = ( i + 1 ) & mask() )
+    {
+        size_t home = m_slots[i].m_hash & mask();
+        bool   stays = hole <= i ? ( hole < home && home <= i ) : ( hole < home || home <= i );
+
+        if( stays )
+            continue;
+
+        m_slots[hole] = std::move( m_slots[i] );
+        hole = i;
+    }
+
+    m_slots[hole].m_joint.reset();
+    m_count--;
+}
+
+}
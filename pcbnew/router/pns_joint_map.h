@@ -0,0 +1,219 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_JOINT_MAP_H
+#define __PNS_JOINT_MAP_H
+
+#include <memory>
+#include <vector>
+
+#include "pns_joint.h"
+
+namespace PNS {
+
+/**
+ * Hash table of the joints of a NODE, keyed by their position and net.
+ *
+ * Several joints may share a tag when they sit on disjoint layer ranges.  The table is a
+ * single array of (hash, joint) slots probed linearly, so a lookup reads consecutive memory
+ * instead of following bucket lists.  Joints are allocated separately and never move, so
+ * pointers to them stay valid until they are removed.
+ */
+class JOINT_MAP
+{
+private:
+    struct SLOT
+    {
+        size_t                 m_hash = 0;
+        std::unique_ptr<JOINT> m_joint;     ///< Empty slots have no joint
+    };
+
+public:
+    /**
+     * An operation on a joint map, as reported to an #OBSERVER.
+     */
+    struct OP
+    {
+        enum TYPE
+        {
+            CREATE,     ///< m_Map was created, as a copy of m_Source if that is set
+            DESTROY,
+            FIND,       ///< Find( m_Tag, m_Layers.Start() )
+            CONTAINS,
+            FOR_EACH,
+            INSERT,     ///< A joint with m_Tag and m_Layers was inserted
+            TAKE
+        };
+
+        TYPE             m_Type;
+        const JOINT_MAP* m_Map;
+        const JOINT_MAP* m_Source;
+        JOINT::HASH_TAG  m_Tag;
+        LAYER_RANGE      m_Layers;
+    };
+
+    /**
+     * Receives the operations made on every joint map, so that benchmarks can record a
+     * routing session and replay it on other map implementations.  Maps used by parallel
+     * router tasks report their operations concurrently.
+     */
+    class OBSERVER
+    {
+    public:
+        virtual ~OBSERVER() {}
+
+        virtual void Record( const OP& aOp ) = 0;
+    };
+
+    class ITERATOR
+    {
+    public:
+        ITERATOR( const SLOT* aSlot, const SLOT* aEnd ) :
+                m_slot( aSlot ),
+                m_end( aEnd )
+        {
+            skipEmpty();
+        }
+
+        JOINT& operator*() const { return *m_slot->m_joint; }
+        JOINT* operator->() const { return m_slot->m_joint.get(); }
+
+        ITERATOR& operator++()
+        {
+            ++m_slot;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==( const ITERATOR& aOther ) const { return m_slot == aOther.m_slot; }
+        bool operator!=( const ITERATOR& aOther ) const { return m_slot != aOther.m_slot; }
+
+    private:
+        void skipEmpty()
+        {
+            while( m_slot != m_end && !m_slot->m_joint )
+                ++m_slot;
+        }
+
+        const SLOT* m_slot;
+        const SLOT* m_end;
+    };
+
+    JOINT_MAP();
+
+    /// Copy the joints of \a aOther; the copies are owned by the new map.
+    JOINT_MAP( const JOINT_MAP& aOther );
+
+    JOINT_MAP& operator=( const JOINT_MAP& ) = delete;
+
+    ~JOINT_MAP();
+
+    /// @return the first joint with \a aTag spanning \a aLayer, or nullptr.
+    JOINT* Find( const JOINT::HASH_TAG& aTag, int aLayer ) const;
+
+    /// @return true if there is a joint with \a aTag, on any layer.
+    bool Contains( const JOINT::HASH_TAG& aTag ) const;
+
+    /// Call \a aFunc with every joint with \a aTag.
+    template <class FUNC>
+    void ForEach( const JOINT::HASH_TAG& aTag, FUNC aFunc ) const;
+
+    /// Add \a aJoint, keyed by its tag.  @return the joint, now owned by the map.
+    JOINT& Insert( std::unique_ptr<JOINT> aJoint );
+
+    /**
+     * Remove a joint with \a aTag overlapping \a aLayers.
+     *
+     * @return the removed joint or nullptr if there was none.
+     */
+    std::unique_ptr<JOINT> Take( const JOINT::HASH_TAG& aTag, const LAYER_RANGE& aLayers );
+
+    size_t size() const { return m_count; }
+
+    /// @return the number of slots of the table, which is zero or a power of two.
+    size_t Capacity() const { return m_slots.size(); }
+
+    /**
+     * @return the hash of \a aTag.  A joint is stored in the first free slot from the one given
+     *         by the low bits of its hash.
+     */
+    static size_t HashTag( const JOINT::HASH_TAG& aTag );
+
+    /**
+     * Set the observer of the operations of all joint maps, or nullptr.  This is meant for
+     * benchmarks: it must not be changed while maps are in use.
+     */
+    static void SetObserver( OBSERVER* aObserver ) { s_observer = aObserver; }
+
+    ITERATOR begin() const { return ITERATOR( m_slots.data(), m_slots.data() + m_slots.size() ); }
+    ITERATOR end() const { return ITERATOR( m_slots.data() + m_slots.size(),
+                                            m_slots.data() + m_slots.size() ); }
+
+private:
+    template <class FUNC>
+    void forEach( const JOINT::HASH_TAG& aTag, FUNC aFunc ) const;
+
+    void observe( OP::TYPE aType, const JOINT::HASH_TAG& aTag = JOINT::HASH_TAG(),
+                  const LAYER_RANGE& aLayers = LAYER_RANGE(),
+                  const JOINT_MAP* aSource = nullptr ) const
+    {
+        if( s_observer )
+            s_observer->Record( { aType, this, aSource, aTag, aLayers } );
+    }
+
+    size_t mask() const { return m_slots.size() - 1; }
+
+    void grow();
+    void removeSlot( size_t aIndex );
+
+    std::vector<SLOT> m_slots;          ///< Size is zero or a power of two
+    size_t            m_count;
+
+    static OBSERVER*  s_observer;
+};
+
+
+template <class FUNC>
+void JOINT_MAP::ForEach( const JOINT::HASH_TAG& aTag, FUNC aFunc ) const
+{
+    observe( OP::FOR_EACH, aTag );
+    forEach( aTag, aFunc );
+}
+
+
+template <class FUNC>
+void JOINT_MAP::forEach( const JOINT::HASH_TAG& aTag, FUNC aFunc ) const
+{
+    if( m_slots.empty() )
+        return;
+
+    size_t hash = HashTag( aTag );
+
+    for( size_t i = hash & mask(); m_slots[i].m_joint; i = ( i + 1 ) & mask() )
+    {
+        const SLOT& slot = m_slots[i];
+
+        if( slot.m_hash == hash && slot.m_joint->Tag() == aTag )
+            aFunc( *slot.m_joint );
+    }
+}
+
+}
+
+#endif    // __PNS_JOINT_MAP_H
@@ -46,7 +46,10 @@
 #include <drc/drc_rule.h>
 #include <drc/drc_engine.h>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <advanced_config.h>
 
@@ -67,10 +70,29 @@
 
 typedef VECTOR2I::extended_type ecoord;
 
+/**
+ * Copper clearances by layer and by the netclasses of both items.  Evaluating them costs
+ * layers * netclasses^2 rule evaluations, so the matrix is kept until the rules change.
+ */
+struct PNS_CLEARANCE_MATRIX
+{
+    unsigned                m_rulesSerial = 0;
+    LSET                    m_layers;
+
+    /// False if a clearance rule depends on more than netclasses and layers
+    bool                    m_valid = false;
+
+    std::map<wxString, int> m_netclassRows;
+    int                     m_netclassCount = 0;
+    std::vector<int>        m_clearances;       ///< -1 where not evaluated
+};
+
+
 class PNS_PCBNEW_RULE_RESOLVER : public PNS::RULE_RESOLVER
 {
 public:
-    PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard, PNS::ROUTER_IFACE* aRouterIface );
+    PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard, PNS::ROUTER_IFACE* aRouterIface,
+                              std::shared_ptr<const PNS_CLEARANCE_MATRIX> aClearanceMatrix );
     virtual ~PNS_PCBNEW_RULE_RESOLVER();
 
     virtual int Clearance( const PNS::ITEM* aA, const PNS::ITEM* aB ) override;
@@ -91,6 +113,15 @@ private:
     int holeRadius( const PNS::ITEM* aItem ) const;
     int matchDpSuffix( const wxString& aNetName, wxString& aComplementNet, wxString& aBaseDpName );
 
+    bool queryConstraint( PNS::CONSTRAINT_TYPE aType, const PNS::ITEM* aItemA,
+                          const PNS::ITEM* aItemB, int aLayer, PNS::CONSTRAINT* aConstraint );
+
+    /// @return the netclass row of \a aItem in the clearance matrix, or -1 if the matrix does
+    ///         not apply to the item.
+    int matrixNetclass( const PNS::ITEM* aItem ) const;
+
+    bool matrixClearance( const PNS::ITEM* aA, const PNS::ITEM* aB, int& aClearance ) const;
+
 private:
     PNS::ROUTER_IFACE* m_routerIface;
     BOARD*             m_board;
@@ -98,20 +129,47 @@ private:
     ARC                m_dummyArc;
     VIA                m_dummyVia;
 
+    // The router may query a node from several threads.  Guards the dummy items and caches.
+    std::mutex         m_mutex;
+
     std::map<std::pair<const PNS::ITEM*, const PNS::ITEM*>, int> m_clearanceCache;
     std::map<std::pair<const PNS::ITEM*, const PNS::ITEM*>, int> m_holeClearanceCache;
     std::map<std::pair<const PNS::ITEM*, const PNS::ITEM*>, int> m_holeToHoleClearanceCache;
+
+    std::shared_ptr<const PNS_CLEARANCE_MATRIX> m_clearanceMatrix;
+    std::vector<int>   m_netclassOfNet;     ///< Matrix row of each net code, -1 if none
 };
 
 
 PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard,
-                                                    PNS::ROUTER_IFACE* aRouterIface ) :
+                                    PNS::ROUTER_IFACE* aRouterIface,
+                                    std::shared_ptr<const PNS_CLEARANCE_MATRIX> aClearanceMatrix ) :
     m_routerIface( aRouterIface ),
     m_board( aBoard ),
     m_dummyTrack( aBoard ),
     m_dummyArc( aBoard ),
-    m_dummyVia( aBoard )
+    m_dummyVia( aBoard ),
+    m_clearanceMatrix( std::move( aClearanceMatrix ) )
 {
+    if( !m_clearanceMatrix || !m_clearanceMatrix->m_valid )
+        return;
+
+    // Nets come and go without the rules changing; a netclass missing from the matrix falls
+    // back to evaluating the rules per item pair.
+    const NETCODES_MAP& nets = m_board->GetNetInfo().NetsByNetcode();
+
+    m_netclassOfNet.assign( nets.empty() ? 0 : std::max( 0, nets.rbegin()->first + 1 ), -1 );
+
+    for( const std::pair<const int, NETINFO_ITEM*>& net : nets )
+    {
+        if( net.first < 0 )
+            continue;
+
+        auto row = m_clearanceMatrix->m_netclassRows.find( net.second->GetNetClassName() );
+
+        if( row != m_clearanceMatrix->m_netclassRows.end() )
+            m_netclassOfNet[net.first] = row->second;
+    }
 }
 
 
@@ -177,9 +235,208 @@ bool isEdge( const PNS::ITEM* aItem )
 }
 
 
+/**
+ * @return true if the rule condition \a aExpr only compares the netclasses of the items.
+ */
+static bool conditionUsesNetclassesOnly( const wxString& aExpr )
+{
+    size_t i = 0;
+
+    while( i < aExpr.length() )
+    {
+        wxUniChar c = aExpr[i];
+
+        if( wxIsspace( c ) || wxString( "=!&|()" ).Find( c ) != wxNOT_FOUND )
+        {
+            i++;
+        }
+        else if( c == '\'' || c == '"' )
+        {
+            size_t end = aExpr.find( c, i + 1 );
+
+            if( end == wxString::npos )
+                return false;
+
+            i = end + 1;
+        }
+        else if( aExpr.Mid( i, 10 ).CmpNoCase( "A.NetClass" ) == 0
+                 || aExpr.Mid( i, 10 ).CmpNoCase( "B.NetClass" ) == 0 )
+        {
+            i += 10;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Evaluate the clearance rules for every pair of netclasses on every copper layer of \a aBoard,
+ * if the rules depend on nothing else.
+ */
+static void buildClearanceMatrix( BOARD* aBoard, PNS_CLEARANCE_MATRIX& aMatrix )
+{
+    std::shared_ptr<DRC_ENGINE> drcEngine = aBoard->GetDesignSettings().m_DRCEngine;
+
+    aMatrix.m_rulesSerial = drcEngine ? drcEngine->GetRulesSerial() : 0;
+    aMatrix.m_layers = aBoard->GetEnabledLayers() & LSET::AllCuMask();
+
+    if( !drcEngine )
+        return;
+
+    bool netclassesOnly = true;
+
+    for( DRC_RULE* rule : drcEngine->GetRulesForConstraintType( CLEARANCE_CONSTRAINT ) )
+    {
+        if( rule->m_Condition
+                && !conditionUsesNetclassesOnly( rule->m_Condition->GetExpression() ) )
+        {
+            wxLogTrace( "PNS", "Clearance rule '%s' depends on more than netclasses and layers; "
+                               "clearances are resolved per item pair.", rule->m_Name );
+            netclassesOnly = false;
+        }
+    }
+
+    if( !netclassesOnly )
+        return;
+
+    std::vector<int> sampleNets;     // a net of each netclass
+
+    for( const std::pair<const int, NETINFO_ITEM*>& net : aBoard->GetNetInfo().NetsByNetcode() )
+    {
+        if( net.first < 0 )
+            continue;
+
+        auto row = aMatrix.m_netclassRows.emplace( net.second->GetNetClassName(),
+                                                   (int) sampleNets.size() );
+
+        if( row.second )
+            sampleNets.push_back( net.first );
+    }
+
+    int count = (int) sampleNets.size();
+
+    aMatrix.m_valid = true;
+    aMatrix.m_netclassCount = count;
+    aMatrix.m_clearances.assign( ( B_Cu + 1 ) * count * count, -1 );
+
+    TRACK trackA( aBoard );
+    TRACK trackB( aBoard );
+
+    for( PCB_LAYER_ID layer : aMatrix.m_layers.Seq() )
+    {
+        trackA.SetLayer( layer );
+        trackB.SetLayer( layer );
+
+        for( int a = 0; a < count; a++ )
+        {
+            trackA.SetNetCode( sampleNets[a], true );
+
+            for( int b = 0; b < count; b++ )
+            {
+                trackB.SetNetCode( sampleNets[b], true );
+
+                DRC_CONSTRAINT constraint = drcEngine->EvalRules( CLEARANCE_CONSTRAINT, &trackA,
+                                                                  &trackB, layer );
+                int            clearance = 0;
+
+                if( !constraint.IsNull() )
+                    clearance = std::max( 0, constraint.GetValue().Min() );
+
+                aMatrix.m_clearances[( layer * count + a ) * count + b] = clearance;
+            }
+        }
+    }
+
+    wxLogTrace( "PNS", "Clearance matrix built for %d netclasses.", count );
+}
+
+
+int PNS_PCBNEW_RULE_RESOLVER::matrixNetclass( const PNS::ITEM* aItem ) const
+{
+    BOARD_ITEM* parent = aItem->Parent();
+
+    if( parent )
+    {
+        if( !parent->IsConnected() || !parent->IsOnCopperLayer()
+                || parent->Type() == PCB_ZONE_T || parent->Type() == PCB_FP_ZONE_T )
+        {
+            return -1;
+        }
+
+        // Local clearances are set on the items, not on the netclasses
+        BOARD_CONNECTED_ITEM* item = static_cast<BOARD_CONNECTED_ITEM*>( parent );
+
+        if( item->GetLocalClearanceOverrides( nullptr ) > 0
+                || item->GetLocalClearance( nullptr ) > 0 )
+        {
+            return -1;
+        }
+    }
+    else if( !aItem->OfKind( PNS::ITEM::SEGMENT_T | PNS::ITEM::ARC_T | PNS::ITEM::VIA_T
+                             | PNS::ITEM::LINE_T ) )
+    {
+        // Only these get a dummy board item to evaluate the rules on
+        return -1;
+    }
+
+    int net = aItem->Net();
+
+    if( net < 0 || net >= (int) m_netclassOfNet.size() )
+        return -1;
+
+    return m_netclassOfNet[net];
+}
+
+
+bool PNS_PCBNEW_RULE_RESOLVER::matrixClearance( const PNS::ITEM* aA, const PNS::ITEM* aB,
+                                                int& aClearance ) const
+{
+    if( m_netclassOfNet.empty() || !aB )
+        return false;
+
+    if( !isCopper( aA ) || !isCopper( aB ) || isEdge( aA ) || isEdge( aB ) )
+        return false;
+
+    int layer = aA->Layer();
+
+    if( layer < F_Cu || layer > B_Cu )
+        return false;
+
+    int rowA = matrixNetclass( aA );
+    int rowB = matrixNetclass( aB );
+
+    if( rowA < 0 || rowB < 0 )
+        return false;
+
+    int count = m_clearanceMatrix->m_netclassCount;
+    int clearance = m_clearanceMatrix->m_clearances[( layer * count + rowA ) * count + rowB];
+
+    if( clearance < 0 )
+        return false;
+
+    aClearance = clearance;
+    return true;
+}
+
+
 bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
                                                 const PNS::ITEM* aItemA, const PNS::ITEM* aItemB,
                                                 int aLayer, PNS::CONSTRAINT* aConstraint )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    return queryConstraint( aType, aItemA, aItemB, aLayer, aConstraint );
+}
+
+
+bool PNS_PCBNEW_RULE_RESOLVER::queryConstraint( PNS::CONSTRAINT_TYPE aType,
+                                                const PNS::ITEM* aItemA, const PNS::ITEM* aItemB,
+                                                int aLayer, PNS::CONSTRAINT* aConstraint )
 {
     std::shared_ptr<DRC_ENGINE> drcEngine = m_board->GetDesignSettings().m_DRCEngine;
 
@@ -272,6 +529,13 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
 
 int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
 {
+    int clearance;
+
+    if( matrixClearance( aA, aB, clearance ) )
+        return clearance;
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
     std::pair<const PNS::ITEM*, const PNS::ITEM*> key( aA, aB );
     auto it = m_clearanceCache.find( key );
 
@@ -283,7 +547,7 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
 
     if( isCopper( aA ) && ( !aB || isCopper( aB ) ) )
     {
-        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_CLEARANCE, aA, aB, aA->Layer(),
+        if( queryConstraint( PNS::CONSTRAINT_TYPE::CT_CLEARANCE, aA, aB, aA->Layer(),
                              &constraint ) )
         {
             if( constraint.m_Value.Min() > rv )
@@ -293,7 +557,7 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
 
     if( isEdge( aA ) || ( aB && isEdge( aB ) ) )
     {
-        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_EDGE_CLEARANCE, aA, aB, aA->Layer(),
+        if( queryConstraint( PNS::CONSTRAINT_TYPE::CT_EDGE_CLEARANCE, aA, aB, aA->Layer(),
                              &constraint ) )
         {
             if( constraint.m_Value.Min() > rv )
@@ -308,6 +572,8 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
 
 int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
 {
+    std::lock_guard<std::mutex> lock( m_mutex );
+
     std::pair<const PNS::ITEM*, const PNS::ITEM*> key( aA, aB );
     auto it = m_holeClearanceCache.find( key );
 
@@ -317,7 +583,7 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITE
     PNS::CONSTRAINT constraint;
     int rv = 0;
 
-    if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_CLEARANCE, aA, aB, aA->Layer(),
+    if( queryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_CLEARANCE, aA, aB, aA->Layer(),
                          &constraint ) )
     {
         rv = constraint.m_Value.Min();
@@ -330,6 +596,8 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITE
 
 int PNS_PCBNEW_RULE_RESOLVER::HoleToHoleClearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
 {
+    std::lock_guard<std::mutex> lock( m_mutex );
+
     std::pair<const PNS::ITEM*, const PNS::ITEM*> key( aA, aB );
     auto it = m_holeToHoleClearanceCache.find( key );
 
@@ -339,7 +607,7 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleToHoleClearance( const PNS::ITEM* aA, const PN
     PNS::CONSTRAINT constraint;
     int rv = 0;
 
-    if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_TO_HOLE, aA, aB, aA->Layer(),
+    if( queryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_TO_HOLE, aA, aB, aA->Layer(),
                          &constraint ) )
     {
         rv = constraint.m_Value.Min();
@@ -763,6 +1031,7 @@ PNS_KICAD_IFACE_BASE::PNS_KICAD_IFACE_BASE()
     m_board = nullptr;
     m_world = nullptr;
     m_debugDecorator = nullptr;
+    m_worstPadClearance = 0;
 }
 
 
@@ -1127,6 +1396,9 @@ bool PNS_KICAD_IFACE_BASE::syncGraphicalItem( PNS::NODE* aWorld, PCB_SHAPE* aIte
 
 void PNS_KICAD_IFACE_BASE::SetBoard( BOARD* aBoard )
 {
+    if( aBoard != m_board )
+        m_clearanceMatrix.reset();
+
     m_board = aBoard;
     wxLogTrace( "PNS", "m_board = %p", m_board );
 }
@@ -1206,101 +1478,286 @@ bool PNS_KICAD_IFACE::IsItemVisible( const PNS::ITEM* aItem ) const
 }
 
 
-void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
+void PNS_KICAD_IFACE_BASE::footprintItems( FOOTPRINT* aFootprint,
+                                           std::vector<BOARD_ITEM*>& aItems ) const
 {
-    if( !m_board )
-    {
-        wxLogTrace( "PNS", "No board attached, aborting sync." );
+    for( PAD* pad : aFootprint->Pads() )
+        aItems.push_back( pad );
+
+    aItems.push_back( &aFootprint->Reference() );
+    aItems.push_back( &aFootprint->Value() );
+
+    for( FP_ZONE* zone : aFootprint->Zones() )
+        aItems.push_back( zone );
+
+    if( aFootprint->IsNetTie() )
         return;
+
+    for( BOARD_ITEM* mgitem : aFootprint->GraphicalItems() )
+    {
+        if( mgitem->Type() == PCB_FP_SHAPE_T || mgitem->Type() == PCB_FP_TEXT_T )
+            aItems.push_back( mgitem );
     }
+}
 
-    int worstClearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
 
-    m_world = aWorld;
+std::vector<BOARD_ITEM*> PNS_KICAD_IFACE_BASE::syncedItems() const
+{
+    std::vector<BOARD_ITEM*> items;
 
     for( BOARD_ITEM* gitem : m_board->Drawings() )
     {
-        if ( gitem->Type() == PCB_SHAPE_T )
-        {
-            syncGraphicalItem( aWorld, static_cast<PCB_SHAPE*>( gitem ) );
-        }
-        else if( gitem->Type() == PCB_TEXT_T )
+        if( gitem->Type() == PCB_SHAPE_T || gitem->Type() == PCB_TEXT_T )
+            items.push_back( gitem );
+    }
+
+    for( ZONE* zone : m_board->Zones() )
+        items.push_back( zone );
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+        footprintItems( footprint, items );
+
+    for( TRACK* track : m_board->Tracks() )
+        items.push_back( track );
+
+    return items;
+}
+
+
+void PNS_KICAD_IFACE_BASE::syncFootprint( PNS::NODE* aWorld, FOOTPRINT* aFootprint )
+{
+    std::vector<BOARD_ITEM*> items;
+
+    footprintItems( aFootprint, items );
+
+    for( BOARD_ITEM* item : items )
+    {
+        syncItem( aWorld, item );
+
+        if( item->Type() == PCB_PAD_T )
         {
-            syncTextItem( aWorld, static_cast<PCB_TEXT*>( gitem ), gitem->GetLayer() );
+            m_worstPadClearance = std::max( m_worstPadClearance,
+                                            static_cast<PAD*>( item )->GetLocalClearance() );
         }
     }
 
-    SHAPE_POLY_SET  buffer;
-    SHAPE_POLY_SET* boardOutline = nullptr;
+    m_footprintChildren[aFootprint].assign( items.begin(), items.end() );
+}
 
-    if( m_board->GetBoardPolygonOutlines( buffer ) )
-        boardOutline = &buffer;
 
-    for( ZONE* zone : m_board->Zones() )
+void PNS_KICAD_IFACE_BASE::syncItem( PNS::NODE* aWorld, BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
     {
-        syncZone( aWorld, zone, boardOutline );
+    case PCB_SHAPE_T:
+    case PCB_FP_SHAPE_T:
+        syncGraphicalItem( aWorld, static_cast<PCB_SHAPE*>( aItem ) );
+        break;
+
+    case PCB_TEXT_T:
+        syncTextItem( aWorld, static_cast<PCB_TEXT*>( aItem ), aItem->GetLayer() );
+        break;
+
+    case PCB_FP_TEXT_T:
+        syncTextItem( aWorld, static_cast<FP_TEXT*>( aItem ), aItem->GetLayer() );
+        break;
+
+    case PCB_ZONE_T:
+    case PCB_FP_ZONE_T:
+        // syncZone() does not use the board outline
+        syncZone( aWorld, static_cast<ZONE*>( aItem ), nullptr );
+        break;
+
+    case PCB_PAD_T:
+        if( std::unique_ptr<PNS::SOLID> solid = syncPad( static_cast<PAD*>( aItem ) ) )
+            aWorld->Add( std::move( solid ) );
+
+        break;
+
+    case PCB_TRACE_T:
+        if( std::unique_ptr<PNS::SEGMENT> segment = syncTrack( static_cast<TRACK*>( aItem ) ) )
+            aWorld->Add( std::move( segment ) );
+
+        break;
+
+    case PCB_ARC_T:
+        if( std::unique_ptr<PNS::ARC> arc = syncArc( static_cast<ARC*>( aItem ) ) )
+            aWorld->Add( std::move( arc ) );
+
+        break;
+
+    case PCB_VIA_T:
+        if( std::unique_ptr<PNS::VIA> via = syncVia( static_cast<VIA*>( aItem ) ) )
+            aWorld->Add( std::move( via ) );
+
+        break;
+
+    default:
+        break;
     }
+}
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+
+void PNS_KICAD_IFACE_BASE::syncRules( PNS::NODE* aWorld )
+{
+    // The pad clearance only grows between full syncs, which only widens the searches
+    int worstClearance = std::max( m_board->GetDesignSettings().GetBiggestClearanceValue(),
+                                   m_worstPadClearance );
+
+    std::shared_ptr<DRC_ENGINE> drcEngine = m_board->GetDesignSettings().m_DRCEngine;
+    unsigned                    rulesSerial = drcEngine ? drcEngine->GetRulesSerial() : 0;
+    LSET                        copperLayers = m_board->GetEnabledLayers() & LSET::AllCuMask();
+
+    // Netclass clearances are compiled into the rules, so the matrix holds until they reload
+    if( !m_clearanceMatrix || m_clearanceMatrix->m_rulesSerial != rulesSerial
+            || m_clearanceMatrix->m_layers != copperLayers )
     {
-        for( PAD* pad : footprint->Pads() )
-        {
-            if( std::unique_ptr<PNS::SOLID> solid = syncPad( pad ) )
-                aWorld->Add( std::move( solid ) );
+        auto matrix = std::make_shared<PNS_CLEARANCE_MATRIX>();
+        buildClearanceMatrix( m_board, *matrix );
+        m_clearanceMatrix = std::move( matrix );
+    }
 
-            worstClearance = std::max( worstClearance, pad->GetLocalClearance() );
-        }
+    // The world outlives the rules, and the resolver caches clearances: start over
+    delete m_ruleResolver;
+    m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, this, m_clearanceMatrix );
 
-        syncTextItem( aWorld, &footprint->Reference(), footprint->Reference().GetLayer() );
-        syncTextItem( aWorld, &footprint->Value(), footprint->Value().GetLayer() );
+    aWorld->SetRuleResolver( m_ruleResolver );
+    aWorld->SetMaxClearance( 4 * worstClearance );
+}
 
-        for( FP_ZONE* zone : footprint->Zones() )
-            syncZone( aWorld, zone, boardOutline );
 
-        if( footprint->IsNetTie() )
-            continue;
+void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
+{
+    if( !m_board )
+    {
+        wxLogTrace( "PNS", "No board attached, aborting sync." );
+        return;
+    }
 
-        for( BOARD_ITEM* mgitem : footprint->GraphicalItems() )
-        {
-            if( mgitem->Type() == PCB_FP_SHAPE_T )
-            {
-                syncGraphicalItem( aWorld, static_cast<PCB_SHAPE*>( mgitem ) );
-            }
-            else if( mgitem->Type() == PCB_FP_TEXT_T )
-            {
-                syncTextItem( aWorld, static_cast<FP_TEXT*>( mgitem ), mgitem->GetLayer() );
-            }
-        }
+    m_world = aWorld;
+    m_footprintChildren.clear();
+    m_worstPadClearance = 0;
+
+    for( BOARD_ITEM* gitem : m_board->Drawings() )
+        syncItem( aWorld, gitem );
+
+    for( ZONE* zone : m_board->Zones() )
+        syncItem( aWorld, zone );
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+        syncFootprint( aWorld, footprint );
+
+    for( TRACK* track : m_board->Tracks() )
+        syncItem( aWorld, track );
+
+    syncRules( aWorld );
+}
+
+
+void PNS_KICAD_IFACE_BASE::UpdateWorld( PNS::NODE* aWorld,
+                                        const std::unordered_set<BOARD_ITEM*>& aChangedItems,
+                                        const std::unordered_set<const BOARD_ITEM*>& aRemovedItems )
+{
+    if( !m_board )
+    {
+        wxLogTrace( "PNS", "No board attached, aborting sync." );
+        return;
     }
 
-    for( TRACK* t : m_board->Tracks() )
+    m_world = aWorld;
+
+    PNS::NODE::ITEM_VECTOR stale;
+
+    // Removed items are only looked up by address.  A footprint edit may have replaced the
+    // children of a footprint, so they are found from the ones converted last time.
+    auto collectStale =
+            [&]( const BOARD_ITEM* aItem )
+            {
+                aWorld->FindItemsByParent( aItem, stale );
+
+                auto it = m_footprintChildren.find( aItem );
+
+                if( it != m_footprintChildren.end() )
+                {
+                    for( const BOARD_ITEM* child : it->second )
+                        aWorld->FindItemsByParent( child, stale );
+
+                    m_footprintChildren.erase( it );
+                }
+            };
+
+    for( const BOARD_ITEM* item : aRemovedItems )
+        collectStale( item );
+
+    for( BOARD_ITEM* item : aChangedItems )
+        collectStale( item );
+
+    // A freed child may share its address with a new item
+    std::sort( stale.begin(), stale.end() );
+    stale.erase( std::unique( stale.begin(), stale.end() ), stale.end() );
+
+    for( PNS::ITEM* item : stale )
+        aWorld->Remove( item );
+
+    for( BOARD_ITEM* item : aChangedItems )
     {
-        KICAD_T type = t->Type();
+        if( item->Type() == PCB_FOOTPRINT_T )
+            syncFootprint( aWorld, static_cast<FOOTPRINT*>( item ) );
+        else
+            syncItem( aWorld, item );
+    }
 
-        if( type == PCB_TRACE_T )
-        {
-            if( auto segment = syncTrack( t ) )
-                aWorld->Add( std::move( segment ) );
-        }
-        else if( type == PCB_ARC_T )
-        {
-            if( auto arc = syncArc( static_cast<ARC*>( t ) ) )
-                aWorld->Add( std::move( arc ) );
-        }
-        else if( type == PCB_VIA_T )
+    syncRules( aWorld );
+}
+
+
+bool PNS_KICAD_IFACE_BASE::CheckWorld( PNS::NODE* aWorld )
+{
+    PNS::NODE reference;
+
+    for( BOARD_ITEM* item : syncedItems() )
+        syncItem( &reference, item );
+
+    std::unordered_map<const BOARD_ITEM*, std::vector<std::pair<int, BOX2I>>> diff;
+    PNS::NODE::ITEM_VECTOR items;
+
+    // Every board item must be converted to the same kinds and extents of router items
+    auto collect =
+            [&]( PNS::NODE* aNode, int aSign )
+            {
+                items.clear();
+                aNode->AllItems( items );
+
+                for( PNS::ITEM* item : items )
+                {
+                    std::vector<std::pair<int, BOX2I>>& entries = diff[item->Parent()];
+                    BOX2I bbox = item->Shape() ? item->Shape()->BBox() : BOX2I();
+                    std::pair<int, BOX2I> entry( item->Kind(), bbox );
+                    auto it = std::find( entries.begin(), entries.end(), entry );
+
+                    if( aSign < 0 && it != entries.end() )
+                        entries.erase( it );
+                    else
+                        entries.push_back( entry );
+                }
+            };
+
+    collect( aWorld, 1 );
+    collect( &reference, -1 );
+
+    bool consistent = true;
+
+    for( const auto& parentEntries : diff )
+    {
+        if( !parentEntries.second.empty() )
         {
-            if( auto via = syncVia( static_cast<VIA*>( t ) ) )
-                aWorld->Add( std::move( via ) );
+            wxLogTrace( "PNS", "World out of sync: %d router items differ for board item %p",
+                        (int) parentEntries.second.size(), parentEntries.first );
+            consistent = false;
         }
     }
 
-    // NB: if this were ever to become a long-lived object we would need to dirty its
-    // clearance cache here....
-    delete m_ruleResolver;
-    m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, this );
-
-    aWorld->SetRuleResolver( m_ruleResolver );
-    aWorld->SetMaxClearance( 4 * worstClearance );
+    return consistent;
 }
 
 
@@ -22,11 +22,14 @@
 #ifndef __PNS_KICAD_IFACE_H
 #define __PNS_KICAD_IFACE_H
 
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "pns_router.h"
 
 class PNS_PCBNEW_RULE_RESOLVER;
+struct PNS_CLEARANCE_MATRIX;
 class PNS_PCBNEW_DEBUG_DECORATOR;
 
 class BOARD;
@@ -55,6 +58,9 @@ public:
     void EraseView() override {};
     void SetBoard( BOARD* aBoard );
     void SyncWorld( PNS::NODE* aWorld ) override;
+    void UpdateWorld( PNS::NODE* aWorld, const std::unordered_set<BOARD_ITEM*>& aChangedItems,
+                      const std::unordered_set<const BOARD_ITEM*>& aRemovedItems ) override;
+    bool CheckWorld( PNS::NODE* aWorld ) override;
     bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) const override { return true; };
     bool IsFlashedOnLayer( const PNS::ITEM* aItem, int aLayer ) const override { return true; };
     bool IsItemVisible( const PNS::ITEM* aItem ) const override { return true; }
@@ -88,6 +94,26 @@ protected:
     PNS_PCBNEW_RULE_RESOLVER* m_ruleResolver;
     PNS::DEBUG_DECORATOR* m_debugDecorator;
 
+    ///< Netclass clearances shared by the rule resolvers until the rules change
+    std::shared_ptr<const PNS_CLEARANCE_MATRIX> m_clearanceMatrix;
+
+    ///< The children of each footprint converted into the world, by footprint.  A footprint
+    ///< edit may replace them before the footprint is reported as changed.
+    std::unordered_map<const BOARD_ITEM*, std::vector<const BOARD_ITEM*>> m_footprintChildren;
+
+    ///< Largest local clearance of the pads converted since the last full sync
+    int m_worstPadClearance;
+
+    ///< Return the board items SyncWorld() converts, in the order it converts them.
+    std::vector<BOARD_ITEM*> syncedItems() const;
+
+    ///< Append the children of \a aFootprint that SyncWorld() converts to \a aItems.
+    void footprintItems( FOOTPRINT* aFootprint, std::vector<BOARD_ITEM*>& aItems ) const;
+
+    void syncItem( PNS::NODE* aWorld, BOARD_ITEM* aItem );
+    void syncFootprint( PNS::NODE* aWorld, FOOTPRINT* aFootprint );
+    void syncRules( PNS::NODE* aWorld );
+
     std::unique_ptr<PNS::SOLID>   syncPad( PAD* aPad );
     std::unique_ptr<PNS::SEGMENT> syncTrack( TRACK* aTrack );
     std::unique_ptr<PNS::ARC>     syncArc( ARC* aArc );
@@ -45,7 +45,7 @@ LINE::LINE( const LINE& aOther )
     m_layers = aOther.m_layers;
     m_via = aOther.m_via;
     m_hasVia = aOther.m_hasVia;
-    m_marker = aOther.m_marker;
+    m_marker = aOther.m_marker.load();
     m_rank = aOther.m_rank;
     m_blockingObstacle = aOther.m_blockingObstacle;
 
@@ -67,7 +67,7 @@ LINE& LINE::operator=( const LINE& aOther )
     m_layers = aOther.m_layers;
     m_via = aOther.m_via;
     m_hasVia = aOther.m_hasVia;
-    m_marker = aOther.m_marker;
+    m_marker = aOther.m_marker.load();
     m_rank = aOther.m_rank;
     m_owner = aOther.m_owner;
     m_snapThreshhold = aOther.m_snapThreshhold;
@@ -97,6 +97,15 @@ void LINE::Mark( int aMarker ) const
 }
 
 
+void LINE::AddMarker( int aMarker ) const
+{
+    m_marker |= aMarker;
+
+    for( const LINKED_ITEM* s : m_links )
+        s->AddMarker( aMarker );
+}
+
+
 void LINE::Unmark( int aMarker ) const
 {
     for( const LINKED_ITEM* s : m_links )
@@ -126,7 +135,7 @@ SEGMENT* SEGMENT::Clone() const
     s->m_seg = m_seg;
     s->m_net = m_net;
     s->m_layers = m_layers;
-    s->m_marker = m_marker;
+    s->m_marker = m_marker.load();
     s->m_rank = m_rank;
 
     return s;
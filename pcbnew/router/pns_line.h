@@ -199,6 +199,7 @@ public:
     void SetViaDrill( int aDrill ) { m_via.SetDrill( aDrill ); }
 
     virtual void Mark( int aMarker ) const override;
+    virtual void AddMarker( int aMarker ) const override;
     virtual void Unmark( int aMarker = -1 ) const override;
     virtual int Marker() const override;
 
@@ -22,6 +22,8 @@
 #include <core/optional.h>
 #include <memory>
 
+#include <advanced_config.h>
+
 #include "pns_arc.h"
 #include "pns_debug_decorator.h"
 #include "pns_line_placer.h"
@@ -483,6 +485,10 @@ bool LINE_PLACER::rhWalkOnly( const VECTOR2I& aP, LINE& aNewHead )
         break;
     }
 
+    // The committed line gets merged afterwards, keep the head responsive
+    if( ADVANCED_CFG::GetCfg().m_RouterDeferredOptimization )
+        effort = 0;
+
     if( Settings().SmartPads() )
         effort |= OPTIMIZER::SMART_PADS;
 
@@ -32,6 +32,8 @@
 #include <geometry/shape_circle.h>
 #include <geometry/shape_simple.h>
 
+#include <cstring>
+
 namespace PNS {
 
 LOGGER::LOGGER( )
@@ -56,17 +58,62 @@ void LOGGER::Save( const std::string& aFilename )
 
     wxLogTrace( "PNS", "Saving to '%s' [%p]", aFilename.c_str(), f );
 
-    for( const auto evt : m_events )
+    if( !f )
+        return;
+
+    for( const EVENT_ENTRY& evt : m_events )
+    {
+        std::string id = "null";
+
+        if( evt.uuid != niluuid )
+            id = evt.uuid.AsString().ToStdString();
+
+        fprintf( f, "event %d %d %d %s\n", evt.type, evt.p.x, evt.p.y, id.c_str() );
+    }
+
+    fclose( f );
+}
+
+
+bool LOGGER::Load( const std::string& aFilename )
+{
+    FILE* f = fopen( aFilename.c_str(), "rb" );
+
+    if( !f )
+        return false;
+
+    m_events.clear();
+
+    char line[256];
+    bool ok = true;
+
+    while( fgets( line, sizeof( line ), f ) )
     {
-        uint64_t id = 0;
-        if( evt.item && evt.item->Parent() )
+        int  type, x, y;
+        char id[64];
+
+        if( sscanf( line, "event %d %d %d %63s", &type, &x, &y, id ) != 4
+                || type < EVT_START_ROUTE || type > EVT_ABORT )
         {
-            const char* idString = evt.item->Parent()->m_Uuid.AsString().c_str();
-            fprintf( f, "event %d %d %d %s\n", evt.type, evt.p.x, evt.p.y, idString );
+            ok = false;
+            break;
         }
+
+        EVENT_ENTRY ent;
+
+        ent.type = static_cast<EVENT_TYPE>( type );
+        ent.p = VECTOR2I( x, y );
+        ent.item = nullptr;
+
+        if( strcmp( id, "null" ) != 0 )
+            ent.uuid = KIID( wxString( id ) );
+
+        m_events.push_back( ent );
     }
 
     fclose( f );
+
+    return ok;
 }
 
 
@@ -78,8 +125,18 @@ void LOGGER::Log( LOGGER::EVENT_TYPE evt, VECTOR2I pos, const ITEM* item )
     ent.p = pos;
     ent.item = item;
 
+    if( item && item->Parent() )
+        ent.uuid = item->Parent()->m_Uuid;
+
     m_events.push_back( ent );
+}
+
+
+PERF_COUNTERS& PERF_COUNTERS::Instance()
+{
+    static PERF_COUNTERS counters;
 
+    return counters;
 }
 
 }
@@ -22,11 +22,14 @@
 #ifndef __PNS_LOGGER_H
 #define __PNS_LOGGER_H
 
+#include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <vector>
 #include <string>
 #include <sstream>
 
+#include <kiid.h>
 #include <math/vector2d.h>
 
 class SHAPE_LINE_CHAIN;
@@ -52,12 +55,22 @@ public:
         VECTOR2I p;
         EVENT_TYPE type;
         const ITEM* item;
+        KIID uuid = niluuid;    ///< of the item's parent, kept as the item may be gone later
     };
 
     LOGGER();
     ~LOGGER();
 
     void Save( const std::string& aFilename );
+
+    /**
+     * Replace the events by the ones of a log written by Save().  The items are not restored,
+     * only the UUIDs of their parents.
+     *
+     * @return false if the file cannot be read or is malformed.
+     */
+    bool Load( const std::string& aFilename );
+
     void Clear();
     void Log( EVENT_TYPE evt, VECTOR2I pos, const ITEM* item = nullptr );
 
@@ -70,6 +83,24 @@ private:
     std::vector<EVENT_ENTRY> m_events;
 };
 
+
+/**
+ * Counts the costly router operations, to profile routing sessions.
+ */
+struct PERF_COUNTERS
+{
+    std::atomic<uint64_t> m_CollisionQueries { 0 };
+    std::atomic<uint64_t> m_ShoveIterations { 0 };
+
+    void Reset()
+    {
+        m_CollisionQueries = 0;
+        m_ShoveIterations = 0;
+    }
+
+    static PERF_COUNTERS& Instance();
+};
+
 }
 
 #endif
@@ -48,6 +48,15 @@ MEANDER_PLACER::~MEANDER_PLACER()
 }
 
 
+void MEANDER_PLACER::ReleaseBranches()
+{
+    // Freed with the other children of m_world
+    m_currentNode = nullptr;
+
+    MEANDER_PLACER_BASE::ReleaseBranches();
+}
+
+
 NODE* MEANDER_PLACER::CurrentNode( bool aLoopsRemoved ) const
 {
     if( !m_currentNode )
@@ -69,7 +78,7 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_currentNode    = nullptr;
     m_currentStart   = getSnappedStartPoint( m_initialSegment, aP );
 
-    m_world = Router()->GetWorld()->Branch();
+    m_world = baseNode()->Branch();
     m_originLine = m_world->AssembleLine( m_initialSegment );
 
     m_padToDieLenth = GetTotalPadToDieLength( m_originLine );
@@ -96,6 +96,9 @@ public:
     /// @copydoc MEANDER_PLACER_BASE::CheckFit()
     bool CheckFit ( MEANDER_SHAPE* aShape ) override;
 
+    /// @copydoc MEANDER_PLACER_BASE::ReleaseBranches()
+    void ReleaseBranches() override;
+
 protected:
     bool doMove( const VECTOR2I& aP, ITEM* aEndItem, long long int aTargetLength );
 
@@ -31,6 +31,7 @@ MEANDER_PLACER_BASE::MEANDER_PLACER_BASE( ROUTER* aRouter ) :
         PLACEMENT_ALGO( aRouter )
 {
     m_world = NULL;
+    m_baseNode = nullptr;
     m_currentWidth = 0;
     m_padToDieLenth = 0;
 }
@@ -41,6 +42,17 @@ MEANDER_PLACER_BASE::~MEANDER_PLACER_BASE()
 }
 
 
+void MEANDER_PLACER_BASE::ReleaseBranches()
+{
+    if( !m_world )
+        return;
+
+    m_world->KillChildren();
+    delete m_world;
+    m_world = nullptr;
+}
+
+
 void MEANDER_PLACER_BASE::AmplitudeStep( int aSign )
 {
     int a = m_settings.m_maxAmplitude + aSign * m_settings.m_step;
@@ -237,6 +249,12 @@ int MEANDER_PLACER_BASE::compareWithTolerance(
 }
 
 
+NODE* MEANDER_PLACER_BASE::baseNode() const
+{
+    return m_baseNode ? m_baseNode : Router()->GetWorld();
+}
+
+
 VECTOR2I MEANDER_PLACER_BASE::getSnappedStartPoint( LINKED_ITEM* aStartItem, VECTOR2I aStartPoint )
 {
     if( aStartItem->Kind() == ITEM::SEGMENT_T )
@@ -109,6 +109,17 @@ public:
 
     int GetTotalPadToDieLength( const LINE& aLine ) const;
 
+    /**
+     * Tune on top of \a aNode instead of the router world.  Must be set before Start().
+     */
+    void SetBaseNode( NODE* aNode ) { m_baseNode = aNode; }
+
+    /**
+     * Free the branches of the world made by Start() and Move().  The placer has to be started
+     * again before it is used.
+     */
+    virtual void ReleaseBranches();
+
 protected:
     /**
      * Extract the part of a track to be meandered, depending on the starting point and the
@@ -139,9 +150,15 @@ protected:
 
     VECTOR2I getSnappedStartPoint( LINKED_ITEM* aStartItem, VECTOR2I aStartPoint );
 
+    ///< Return the node the tuned world is branched from.
+    NODE* baseNode() const;
+
     ///< Pointer to world to search colliding items.
     NODE* m_world;
 
+    ///< Node to branch the world from instead of the router world, if any.
+    NODE* m_baseNode;
+
     ///< Total length added by pad to die size.
     int m_padToDieLenth;
 
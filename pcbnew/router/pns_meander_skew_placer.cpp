@@ -58,7 +58,7 @@ bool MEANDER_SKEW_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_currentNode    = nullptr;
     m_currentStart   = getSnappedStartPoint( m_initialSegment, aP );
 
-    m_world = Router()->GetWorld( )->Branch();
+    m_world = baseNode()->Branch();
     m_originLine = m_world->AssembleLine( m_initialSegment );
 
     TOPOLOGY topo( m_world );
@@ -22,6 +22,7 @@
 
 #include <vector>
 #include <cassert>
+#include <unordered_set>
 #include <utility>
 
 #include <math/vector2d.h>
@@ -38,6 +39,7 @@
 #include "pns_joint.h"
 #include "pns_index.h"
 #include "pns_debug_decorator.h"
+#include "pns_logger.h"
 #include "pns_router.h"
 
 
@@ -54,7 +56,9 @@ NODE::NODE()
     m_parent = NULL;
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
-    m_index = new INDEX;
+    m_index = std::make_shared<INDEX>();
+    m_joints = std::make_shared<JOINT_MAP>();
+    m_override = std::make_shared<std::unordered_set<ITEM*>>();
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -80,7 +84,7 @@ NODE::~NODE()
     allocNodes.erase( this );
 #endif
 
-    m_joints.clear();
+    m_joints.reset();
 
     for( ITEM* item : *m_index )
     {
@@ -90,8 +94,6 @@ NODE::~NODE()
 
     releaseGarbage();
     unlinkParent();
-
-    delete m_index;
 }
 
 int NODE::GetClearance( const ITEM* aA, const ITEM* aB ) const
@@ -133,15 +135,12 @@ NODE* NODE::Branch()
     child->m_root = isRoot() ? this : m_root;
     child->m_maxClearance = m_maxClearance;
 
-    // Immediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
+    // Immediate offspring of the root branch needs not copy anything. The rest share joints,
+    // overridden item maps and pointers to stored items with this node, and copy them when
+    // either of the two changes them: most branches are discarded or change a few items only.
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
-        for( ITEM* item : *m_index )
-            child->m_index->Add( item );
-
+        child->m_index = m_index;
         child->m_joints = m_joints;
         child->m_override = m_override;
     }
@@ -149,14 +148,41 @@ NODE* NODE::Branch()
 #if 0
     wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
                 child->m_index->Size(),
-                (int) child->m_joints.size(),
-                (int) child->m_override.size() );
+                (int) child->m_joints->size(),
+                (int) child->m_override->size() );
 #endif
 
     return child;
 }
 
 
+INDEX& NODE::ownIndex()
+{
+    if( m_index.use_count() > 1 )
+        m_index = std::make_shared<INDEX>( *m_index );
+
+    return *m_index;
+}
+
+
+JOINT_MAP& NODE::ownJoints()
+{
+    if( m_joints.use_count() > 1 )
+        m_joints = std::make_shared<JOINT_MAP>( *m_joints );
+
+    return *m_joints;
+}
+
+
+std::unordered_set<ITEM*>& NODE::ownOverrides()
+{
+    if( m_override.use_count() > 1 )
+        m_override = std::make_shared<std::unordered_set<ITEM*>>( *m_override );
+
+    return *m_override;
+}
+
+
 void NODE::unlinkParent()
 {
     if( isRoot() )
@@ -204,15 +230,24 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
     int        m_extraClearance;
     bool       m_differentNetsOnly;
 
+    ///< Items already added to m_tab, which are not added again
+    std::unordered_set<const ITEM*>& m_reported;
+
+    ///< If set, the segments searched for collisions instead of m_item
+    const std::vector<SEGMENT>*      m_segments;
+
     DEFAULT_OBSTACLE_VISITOR( NODE::OBSTACLES& aTab, const ITEM* aItem, int aKindMask,
-                              bool aDifferentNetsOnly ) :
+                              bool aDifferentNetsOnly,
+                              std::unordered_set<const ITEM*>& aReported ) :
         OBSTACLE_VISITOR( aItem ),
         m_tab( aTab ),
         m_kindMask( aKindMask ),
         m_limitCount( -1 ),
         m_matchCount( 0 ),
         m_extraClearance( 0 ),
-        m_differentNetsOnly( aDifferentNetsOnly )
+        m_differentNetsOnly( aDifferentNetsOnly ),
+        m_reported( aReported ),
+        m_segments( nullptr )
     {
         if( aItem && aItem->Kind() == ITEM::LINE_T )
         {
@@ -237,7 +272,11 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
         if( visit( aCandidate ) )
             return true;
 
-        if( !aCandidate->Collide( m_item, m_node, m_differentNetsOnly ) )
+        // Multilayer items are found once per layer, and a line's via near its segments
+        if( m_reported.count( aCandidate ) )
+            return true;
+
+        if( !collides( aCandidate ) )
             return true;
 
         OBSTACLE obs;
@@ -245,6 +284,7 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
         obs.m_item = aCandidate;
         obs.m_head = m_item;
         m_tab.push_back( obs );
+        m_reported.insert( aCandidate );
 
         m_matchCount++;
 
@@ -253,13 +293,97 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 
         return true;
     };
+
+    bool collides( const ITEM* aCandidate ) const
+    {
+        if( !m_segments )
+            return aCandidate->Collide( m_item, m_node, m_differentNetsOnly );
+
+        for( const SEGMENT& seg : *m_segments )
+        {
+            if( aCandidate->Collide( &seg, m_node, m_differentNetsOnly ) )
+                return true;
+        }
+
+        return false;
+    }
 };
 
 
 int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aKindMask,
                           int aLimitCount, bool aDifferentNetsOnly )
 {
-    DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aItem, aKindMask, aDifferentNetsOnly );
+    PERF_COUNTERS::Instance().m_CollisionQueries.fetch_add( 1, std::memory_order_relaxed );
+
+    std::unordered_set<const ITEM*> reported;
+
+    queryColliding( aItem, aObstacles, aKindMask, aLimitCount, aDifferentNetsOnly, reported );
+
+    return aObstacles.size();
+}
+
+
+int NODE::QueryColliding( const LINE* aLine, NODE::OBSTACLES& aObstacles, int aKindMask,
+                          int aLimitCount, bool aDifferentNetsOnly )
+{
+    PERF_COUNTERS::Instance().m_CollisionQueries.fetch_add( 1, std::memory_order_relaxed );
+
+    const SHAPE_LINE_CHAIN&         chain = aLine->CLine();
+    size_t                          first = aObstacles.size();
+    std::unordered_set<const ITEM*> reported;
+
+    auto remaining =
+            [&]() -> int
+            {
+                return aLimitCount < 0 ? -1 : aLimitCount - (int) ( aObstacles.size() - first );
+            };
+
+    if( chain.SegmentCount() > 0 )
+    {
+        std::vector<SEGMENT> segments;
+        std::vector<BOX2I>   boxes;
+
+        segments.reserve( chain.SegmentCount() );
+        boxes.reserve( chain.SegmentCount() );
+
+        for( int i = 0; i < chain.SegmentCount(); i++ )
+        {
+            segments.emplace_back( *aLine, chain.CSegment( i ) );
+            boxes.push_back( segments.back().Shape()->BBox() );
+        }
+
+        // One walk of the tree against the boxes of all the segments: each candidate is
+        // visited once per layer and tested against the segments in turn
+        DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aLine, aKindMask, aDifferentNetsOnly,
+                                          reported );
+
+        visitor.m_segments = &segments;
+        visitor.SetCountLimit( aLimitCount );
+        visitor.SetWorld( this, NULL );
+
+        m_index->Query( boxes, aLine->Layers(), m_maxClearance, visitor );
+
+        if( !isRoot() && remaining() != 0 )
+        {
+            visitor.SetWorld( m_root, this );
+            m_root->m_index->Query( boxes, aLine->Layers(), m_maxClearance, visitor );
+        }
+    }
+
+    if( aLine->EndsWithVia() && remaining() != 0 )
+        queryColliding( &aLine->Via(), aObstacles, aKindMask, remaining(), aDifferentNetsOnly,
+                        reported );
+
+    return aObstacles.size();
+}
+
+
+void NODE::queryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aKindMask,
+                           int aLimitCount, bool aDifferentNetsOnly,
+                           std::unordered_set<const ITEM*>& aReported )
+{
+    DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aItem, aKindMask, aDifferentNetsOnly,
+                                      aReported );
 
 #ifdef DEBUG
     assert( allocNodes.find( this ) != allocNodes.end() );
@@ -277,8 +401,6 @@ int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aK
         visitor.SetWorld( m_root, this );
         m_root->m_index->Query( aItem, m_maxClearance, visitor );
     }
-
-    return aObstacles.size();
 }
 
 
@@ -288,14 +410,7 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aLine, int aKindMask,
     OBSTACLES obstacleList;
     obstacleList.reserve( 100 );
 
-    for( int i = 0; i < aLine->CLine().SegmentCount(); i++ )
-    {
-        const SEGMENT s( *aLine, aLine->CLine().CSegment( i ) );
-        QueryColliding( &s, obstacleList, aKindMask );
-    }
-
-    if( aLine->EndsWithVia() )
-        QueryColliding( &aLine->Via(), obstacleList, aKindMask );
+    QueryColliding( aLine, obstacleList, aKindMask );
 
     if( obstacleList.empty() )
         return OPT_OBSTACLE();
@@ -316,8 +431,11 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aLine, int aKindMask,
                     nearest.m_item = obstacle;
                     nearest.m_hull = hull;
 
-                    obstacle->Mark( isHole ? obstacle->Marker() | MK_HOLE
-                                           : obstacle->Marker() & ~MK_HOLE );
+                    // Walkarounds in both directions may run this at the same time
+                    if( isHole )
+                        obstacle->AddMarker( MK_HOLE );
+                    else
+                        obstacle->Unmark( MK_HOLE );
                 }
             };
 
@@ -432,26 +550,8 @@ NODE::OPT_OBSTACLE NODE::CheckColliding( const ITEM* aItemA, int aKindMask )
 
     if( aItemA->Kind() == ITEM::LINE_T )
     {
-        int n = 0;
-        const LINE* line = static_cast<const LINE*>( aItemA );
-        const SHAPE_LINE_CHAIN& l = line->CLine();
-
-        for( int i = 0; i < l.SegmentCount(); i++ )
-        {
-            const SEGMENT s( *line, l.CSegment( i ) );
-            n += QueryColliding( &s, obs, aKindMask, 1 );
-
-            if( n )
-                return OPT_OBSTACLE( obs[0] );
-        }
-
-        if( line->EndsWithVia() )
-        {
-            n += QueryColliding( &line->Via(), obs, aKindMask, 1 );
-
-            if( n )
-                return OPT_OBSTACLE( obs[0] );
-        }
+        if( QueryColliding( static_cast<const LINE*>( aItemA ), obs, aKindMask, 1 ) > 0 )
+            return OPT_OBSTACLE( obs[0] );
     }
     else if( QueryColliding( aItemA, obs, aKindMask, 1 ) > 0 )
     {
@@ -525,7 +625,8 @@ void NODE::addSolid( SOLID* aSolid )
     if( aSolid->IsRoutable() )
         linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
 
-    m_index->Add( aSolid );
+    ownIndex().Add( aSolid );
+    indexParent( aSolid );
 }
 
 
@@ -540,7 +641,8 @@ void NODE::addVia( VIA* aVia )
 {
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
 
-    m_index->Add( aVia );
+    ownIndex().Add( aVia );
+    indexParent( aVia );
 }
 
 
@@ -608,7 +710,8 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().A, aSeg->Layers(), aSeg->Net(), aSeg );
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
-    m_index->Add( aSeg );
+    ownIndex().Add( aSeg );
+    indexParent( aSeg );
 }
 
 
@@ -635,7 +738,8 @@ void NODE::addArc( ARC* aArc )
     linkJoint( aArc->Anchor( 0 ), aArc->Layers(), aArc->Net(), aArc );
     linkJoint( aArc->Anchor( 1 ), aArc->Layers(), aArc->Net(), aArc );
 
-    m_index->Add( aArc );
+    ownIndex().Add( aArc );
+    indexParent( aArc );
 }
 
 
@@ -671,12 +775,28 @@ void NODE::doRemove( ITEM* aItem )
     // case 1: removing an item that is stored in the root node from any branch:
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
+        ownOverrides().insert( aItem );
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
-        m_index->Remove( aItem );
+    {
+        ownIndex().Remove( aItem );
+
+        if( isRoot() && aItem->Parent() )
+        {
+            auto range = m_itemsByParent.equal_range( aItem->Parent() );
+
+            for( auto it = range.first; it != range.second; ++it )
+            {
+                if( it->second == aItem )
+                {
+                    m_itemsByParent.erase( it );
+                    break;
+                }
+            }
+        }
+    }
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -707,6 +827,10 @@ void NODE::rebuildJoint( JOINT* aJoint, ITEM* aItem )
     // layers) into multiple independent joints. As I'm a lazy bastard, I simply delete the
     // via/solid and all its links and re-insert them.
 
+    // aJoint may belong to a joint map shared with other branches, which ownJoints() leaves
+    // to them.  Only use it until then.
+    assert( aJoint == FindJoint( aJoint->Pos(), aItem->Layers().Start(), aItem->Net() ) );
+
     JOINT::LINKED_ITEMS links( aJoint->LinkList() );
     JOINT::HASH_TAG tag;
     int net = aItem->Net();
@@ -714,28 +838,11 @@ void NODE::rebuildJoint( JOINT* aJoint, ITEM* aItem )
     tag.net = net;
     tag.pos = aJoint->Pos();
 
-    bool split;
-
-    do
-    {
-        split = false;
-        auto range = m_joints.equal_range( tag );
-
-        if( range.first == m_joints.end() )
-            break;
-
-        // find and remove all joints containing the via to be removed
+    JOINT_MAP& joints = ownJoints();
 
-        for( auto f = range.first; f != range.second; ++f )
-        {
-            if( aItem->LayersOverlap( &f->second ) )
-            {
-                m_joints.erase( f );
-                split = true;
-                break;
-            }
-        }
-    } while( split );
+    // find and remove all joints containing the via to be removed
+    while( joints.Take( tag, aItem->Layers() ) )
+        ;
 
     // and re-link them, using the former via's link list
     for( ITEM* link : links )
@@ -1031,26 +1138,12 @@ JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
-
-    if( f == end && !isRoot() )
-    {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
-    }
-
-    if( f == end )
-        return NULL;
+    JOINT_MAP* joints = m_joints.get();
 
-    while( f != end )
-    {
-        if( f->second.Layers().Overlaps( aLayer ) )
-            return &f->second;
-
-        ++f;
-    }
+    if( !isRoot() && !joints->Contains( tag ) )
+        joints = m_root->m_joints.get();
 
-    return NULL;
+    return joints->Find( tag, aLayer );
 }
 
 
@@ -1068,47 +1161,25 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     tag.pos = aPos;
     tag.net = aNet;
 
-    // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
-
-    std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
+    JOINT_MAP& joints = ownJoints();
 
-    // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
+    // not found in this node and we are not root? find in the root and copy results here.
+    if( !isRoot() && !joints.Contains( tag ) )
     {
-        range = m_root->m_joints.equal_range( tag );
-
-        for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
+        m_root->m_joints->ForEach( tag,
+                                   [&]( const JOINT& aJoint )
+                                   {
+                                       joints.Insert( std::make_unique<JOINT>( aJoint ) );
+                                   } );
     }
 
     // now insert and combine overlapping joints
-    JOINT jt( aPos, aLayers, aNet );
+    std::unique_ptr<JOINT> jt = std::make_unique<JOINT>( aPos, aLayers, aNet );
 
-    bool merged;
+    while( std::unique_ptr<JOINT> overlapping = joints.Take( tag, aLayers ) )
+        jt->Merge( *overlapping );
 
-    do
-    {
-        merged  = false;
-        range   = m_joints.equal_range( tag );
-
-        if( range.first == m_joints.end() )
-            break;
-
-        for( f = range.first; f != range.second; ++f )
-        {
-            if( aLayers.Overlaps( f->second.Layers() ) )
-            {
-                jt.Merge( f->second );
-                m_joints.erase( f );
-                merged = true;
-                break;
-            }
-        }
-    }
-    while( merged );
-
-    return m_joints.insert( TagJointPair( tag, jt ) )->second;
+    return joints.Insert( std::move( jt ) );
 }
 
 
@@ -1165,7 +1236,7 @@ void NODE::Dump( bool aLong )
 
     if( aLong )
     {
-        for( j = m_joints.begin(); j != m_joints.end(); ++j )
+        for( j = m_joints->begin(); j != m_joints->end(); ++j )
         {
             wxLogTrace( "PNS", "joint : %s, links : %d\n",
                         j->second.GetPos().Format().c_str(), j->second.LinkCount() );
@@ -1217,7 +1288,7 @@ void NODE::Dump( bool aLong )
         lines_count++;
     }
 
-    wxLogTrace( "PNS", "Local joints: %d, lines : %d \n", m_joints.size(), lines_count );
+    wxLogTrace( "PNS", "Local joints: %d, lines : %d \n", m_joints->size(), lines_count );
 #endif
 }
 
@@ -1227,13 +1298,13 @@ void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
     if( isRoot() )
         return;
 
-    if( m_override.size() )
-        aRemoved.reserve( m_override.size() );
+    if( m_override->size() )
+        aRemoved.reserve( m_override->size() );
 
     if( m_index->Size() )
         aAdded.reserve( m_index->Size() );
 
-    for( ITEM* item : m_override )
+    for( ITEM* item : *m_override )
         aRemoved.push_back( item );
 
     for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
@@ -1274,7 +1345,7 @@ void NODE::Commit( NODE* aNode )
     if( aNode->isRoot() )
         return;
 
-    for( ITEM* item : aNode->m_override )
+    for( ITEM* item : *aNode->m_override )
         Remove( item );
 
     for( ITEM* item : *aNode->m_index )
@@ -1324,6 +1395,31 @@ void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems, int aKindMask)
 }
 
 
+void NODE::AllItems( ITEM_VECTOR& aItems ) const
+{
+    aItems.reserve( aItems.size() + m_index->Size() );
+
+    for( ITEM* item : *m_index )
+        aItems.push_back( item );
+}
+
+
+void NODE::indexParent( ITEM* aItem )
+{
+    if( isRoot() && aItem->Parent() )
+        m_itemsByParent.emplace( aItem->Parent(), aItem );
+}
+
+
+void NODE::FindItemsByParent( const BOARD_ITEM* aParent, ITEM_VECTOR& aItems ) const
+{
+    auto range = m_itemsByParent.equal_range( aParent );
+
+    for( auto it = range.first; it != range.second; ++it )
+        aItems.push_back( it->second );
+}
+
+
 void NODE::ClearRanks( int aMarkerMask )
 {
     for( ITEM* item : *m_index )
@@ -1426,14 +1522,14 @@ int NODE::QueryJoints( const BOX2I& aBox, std::vector<JOINT*>& aJoints, LAYER_RA
 
     aJoints.clear();
 
-    for( JOINT_MAP::value_type& j : m_joints )
+    for( JOINT& jt : *m_joints )
     {
-        if( !j.second.Layers().Overlaps( aLayerMask ) )
+        if( !jt.Layers().Overlaps( aLayerMask ) )
             continue;
 
-        if( aBox.Contains( j.second.Pos() ) && j.second.LinkCount( aKindMask ) )
+        if( aBox.Contains( jt.Pos() ) && jt.LinkCount( aKindMask ) )
         {
-            aJoints.push_back( &j.second );
+            aJoints.push_back( &jt );
             n++;
         }
     }
@@ -1441,13 +1537,13 @@ int NODE::QueryJoints( const BOX2I& aBox, std::vector<JOINT*>& aJoints, LAYER_RA
     if( isRoot() )
         return n;
 
-    for( JOINT_MAP::value_type& j : m_root->m_joints )
+    for( JOINT& jt : *m_root->m_joints )
     {
-        if( !Overrides( &j.second ) && j.second.Layers().Overlaps( aLayerMask ) )
+        if( !Overrides( &jt ) && jt.Layers().Overlaps( aLayerMask ) )
         {
-            if( aBox.Contains( j.second.Pos() ) && j.second.LinkCount( aKindMask ) )
+            if( aBox.Contains( jt.Pos() ) && jt.LinkCount( aKindMask ) )
             {
-                aJoints.push_back( &j.second );
+                aJoints.push_back( &jt );
                 n++;
             }
         }
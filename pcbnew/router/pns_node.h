@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -37,6 +38,7 @@
 
 #include "pns_item.h"
 #include "pns_joint.h"
+#include "pns_joint_map.h"
 #include "pns_itemset.h"
 
 namespace PNS {
@@ -144,7 +146,8 @@ protected:
  * - spatial-indexed container for PCB item shapes.
  * - collision search & clearance checking.
  * - assembly of lines connecting joints, finding loops and unique paths.
- * - lightweight cloning/branching (for recursive optimization and shove springback).
+ * - lightweight cloning/branching (for recursive optimization and shove springback).  A branch
+ *   shares the items, joints and overrides of its parent until either of them changes.
  **/
 class NODE
 {
@@ -187,7 +190,7 @@ public:
     ///< Return the number of joints.
     int JointCount() const
     {
-        return m_joints.size();
+        return m_joints->size();
     }
 
     ///< Return the number of nodes in the inheritance chain (wrs to the root node).
@@ -208,6 +211,16 @@ public:
     int QueryColliding( const ITEM* aItem, OBSTACLES& aObstacles, int aKindMask = ITEM::ANY_T,
                         int aLimitCount = -1, bool aDifferentNetsOnly = true );
 
+    /**
+     * Find items colliding with the segments of \a aLine and with its via, if any.  The
+     * index is searched once for all the segments, and each colliding item is reported once,
+     * with the line as the head.
+     *
+     * @return number of obstacles found
+     */
+    int QueryColliding( const LINE* aLine, OBSTACLES& aObstacles, int aKindMask = ITEM::ANY_T,
+                        int aLimitCount = -1, bool aDifferentNetsOnly = true );
+
     int QueryJoints( const BOX2I& aBox, std::vector<JOINT*>& aJoints,
                      LAYER_RANGE aLayerMask = LAYER_RANGE::All(), int aKindMask = ITEM::ANY_T );
 
@@ -336,6 +349,11 @@ public:
     /**
      * Search for a joint at a given position, layer and belonging to given net.
      *
+     * The joint lives in a joint map which may be shared with other branches.  The pointer
+     * is only valid until the joints of this node change: the first change gives the node its
+     * own copy of the map, and the shared one goes away with the other branches.  Look the
+     * joint up again after adding, removing or locking items.
+     *
      * @return the joint, if found, otherwise empty.
      */
     JOINT* FindJoint( const VECTOR2I& aPos, int aLayer, int aNet );
@@ -363,12 +381,20 @@ public:
 
     void AllItemsInNet( int aNet, std::set<ITEM*>& aItems, int aKindMask = -1 );
 
+    ///< Collect the items stored in this node.  Applicable only to the root node, which holds
+    ///< all of them.
+    void AllItems( ITEM_VECTOR& aItems ) const;
+
     void ClearRanks( int aMarkerMask = MK_HEAD | MK_VIOLATION | MK_HOLE );
 
     void RemoveByMarker( int aMarker );
 
     ITEM* FindItemByParent( const BOARD_ITEM* aParent );
 
+    ///< Collect the items of the root node made from \a aParent.  Applicable only to the root
+    ///< node.  \a aParent is only used as a key, so it may point to a deleted board item.
+    void FindItemsByParent( const BOARD_ITEM* aParent, ITEM_VECTOR& aItems ) const;
+
     bool HasChildren() const
     {
         return !m_children.empty();
@@ -382,7 +408,7 @@ public:
     ///< Check if this branch contains an updated version of the m_item from the root branch.
     bool Overrides( ITEM* aItem ) const
     {
-        return m_override.find( aItem ) != m_override.end();
+        return m_override->find( aItem ) != m_override->end();
     }
 
 private:
@@ -413,11 +439,25 @@ private:
     void removeArcIndex( ARC* aVia );
 
     void doRemove( ITEM* aItem );
+
+    ///< Find items colliding with \a aItem, skipping and adding to \a aReported the ones
+    ///< already reported.
+    void queryColliding( const ITEM* aItem, OBSTACLES& aObstacles, int aKindMask, int aLimitCount,
+                         bool aDifferentNetsOnly, std::unordered_set<const ITEM*>& aReported );
     void unlinkParent();
     void releaseChildren();
     void releaseGarbage();
     void rebuildJoint( JOINT* aJoint, ITEM* aItem );
 
+    /**
+     * Branches share the index, joints and overrides of their parent until either of the two
+     * changes them.  Call these before changing them, to give this node its own copy.
+     * Joints found before ownJoints() may belong to the shared map, see FindJoint().
+     */
+    INDEX& ownIndex();
+    JOINT_MAP& ownJoints();
+    std::unordered_set<ITEM*>& ownOverrides();
+
     bool isRoot() const
     {
         return m_parent == NULL;
@@ -430,6 +470,9 @@ private:
     ARC* findRedundantArc( const VECTOR2I& A, const VECTOR2I& B, const LAYER_RANGE& lr, int aNet );
     ARC* findRedundantArc( ARC* aSeg );
 
+    ///< Add \a aItem to the index by board item, if this is the root node.
+    void indexParent( ITEM* aItem );
+
     ///< Scan the joint map, forming a line starting from segment (current).
     void followLine( LINKED_ITEM* aCurrent, int aScanDirection, int& aPos, int aLimit,
                      VECTOR2I* aCorners, LINKED_ITEM** aSegments, bool* aArcReversed,
@@ -437,26 +480,29 @@ private:
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
-    typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
-    typedef JOINT_MAP::value_type TagJointPair;
 
-    JOINT_MAP       m_joints;           ///< hash table with the joints, linking the items. Joints
-                                        ///< are hashed by their position, layer set and net.
+    std::shared_ptr<JOINT_MAP> m_joints; ///< hash table with the joints, linking the items.
+                                         ///< Joints are hashed by their position, layer set
+                                         ///< and net.
 
     NODE*           m_parent;           ///< node this node was branched from
     NODE*           m_root;             ///< root node of the whole hierarchy
     std::set<NODE*> m_children;         ///< list of nodes branched from this one
 
-    std::unordered_set<ITEM*> m_override;   ///< hash of root's items that have been changed
-                                            ///< in this node
+    std::shared_ptr<std::unordered_set<ITEM*>> m_override; ///< hash of root's items that have
+                                                           ///< been changed in this node
 
     int             m_maxClearance;     ///< worst case item-item clearance
     RULE_RESOLVER*  m_ruleResolver;     ///< Design rules resolver
-    INDEX*          m_index;            ///< Geometric/Net index of the items
+    std::shared_ptr<INDEX> m_index;     ///< Geometric/Net index of the items
     int             m_depth;            ///< depth of the node (number of parent nodes in the
                                         ///< inheritance chain)
 
     std::unordered_set<ITEM*> m_garbageItems;
+
+    ///< Items of the root node by the board item they were made from, so that the world can
+    ///< be updated without looking at every item.  Empty in branches.
+    std::unordered_multimap<const BOARD_ITEM*, ITEM*> m_itemsByParent;
 };
 
 }
@@ -19,14 +19,17 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <view/view.h>
 #include <view/view_group.h>
 #include <gal/graphics_abstraction_layer.h>
 
+#include <advanced_config.h>
 #include <pgm_base.h>
 #include <settings/settings_manager.h>
 
@@ -35,11 +38,14 @@
 #include <pad.h>
 #include <zone.h>
 
+#include <core/thread_pool.h>
 #include <geometry/shape.h>
 
+#include "pns_debug_decorator.h"
 #include "pns_node.h"
 #include "pns_line_placer.h"
 #include "pns_line.h"
+#include "pns_optimizer.h"
 #include "pns_solid.h"
 #include "pns_utils.h"
 #include "pns_router.h"
@@ -51,6 +57,7 @@
 #include "pns_meander_placer.h"
 #include "pns_meander_skew_placer.h"
 #include "pns_dp_meander_placer.h"
+#include "time_limit.h"
 
 namespace PNS {
 
@@ -83,6 +90,12 @@ ROUTER* ROUTER::GetInstance()
 }
 
 
+void ROUTER::SetInstance( ROUTER* aRouter )
+{
+    theRouter = aRouter;
+}
+
+
 ROUTER::~ROUTER()
 {
     ClearWorld();
@@ -100,8 +113,53 @@ void ROUTER::SyncWorld()
 
 }
 
+void ROUTER::UpdateWorld( const std::unordered_set<BOARD_ITEM*>& aChangedItems,
+                          const std::unordered_set<const BOARD_ITEM*>& aRemovedItems )
+{
+    if( !m_world )
+    {
+        SyncWorld();
+        return;
+    }
+
+    // The committing of the last routing is what triggers this update, and its links may be
+    // converted again.  Find them back by their board items, so they can still be optimized.
+    std::vector<const BOARD_ITEM*>        committedParents;
+    std::unordered_set<const BOARD_ITEM*> seenParents;
+
+    for( LINKED_ITEM* link : m_committedLinks )
+    {
+        if( link->Parent() && seenParents.insert( link->Parent() ).second )
+            committedParents.push_back( link->Parent() );
+    }
+
+    m_committedLinks.clear();
+
+    m_iface->UpdateWorld( m_world.get(), aChangedItems, aRemovedItems );
+
+    if( ADVANCED_CFG::GetCfg().m_RouterCheckWorldSync && !m_iface->CheckWorld( m_world.get() ) )
+    {
+        wxLogTrace( "PNS", "Incrementally updated world differs from the board, resyncing." );
+        SyncWorld();
+    }
+
+    NODE::ITEM_VECTOR items;
+
+    for( const BOARD_ITEM* parent : committedParents )
+        m_world->FindItemsByParent( parent, items );
+
+    for( ITEM* item : items )
+    {
+        if( item->Kind() == ITEM::SEGMENT_T )
+            m_committedLinks.push_back( static_cast<LINKED_ITEM*>( item ) );
+    }
+}
+
+
 void ROUTER::ClearWorld()
 {
+    m_committedLinks.clear();
+
     if( m_world )
     {
         m_world->KillChildren();
@@ -137,6 +195,8 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     if( aStartItems.Empty() )
         return false;
 
+    m_committedLinks.clear();
+
     if( aStartItems.Count( ITEM::SOLID_T ) == aStartItems.Size() )
     {
         m_dragger = std::make_unique<COMPONENT_DRAGGER>( this );
@@ -157,6 +217,9 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     m_dragger->SetLogger( m_logger );
     m_dragger->SetDebugDecorator( m_iface->GetDebugDecorator() );
 
+    if( m_logger )
+        m_logger->Log( LOGGER::EVT_START_DRAG, aP, aStartItems[0] );
+
     if( m_dragger->Start( aP, aStartItems ) )
     {
         m_state = DRAG_SEGMENT;
@@ -335,6 +398,8 @@ bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
     if( !isStartingPointRoutable( aP, aStartItem, aLayer ) )
         return false;
 
+    m_committedLinks.clear();
+
     m_forceMarkObstaclesMode = false;
 
     switch( m_mode )
@@ -555,6 +620,8 @@ void ROUTER::movePlacing( const VECTOR2I& aP, ITEM* aEndItem )
 
 void ROUTER::CommitRouting( NODE* aNode )
 {
+    m_committedLinks.clear();
+
     if( m_state == ROUTE_TRACK && !m_placer->HasPlacedAnything() )
         return;
 
@@ -589,9 +656,17 @@ void ROUTER::CommitRouting( NODE* aNode )
             m_iface->RemoveItem( item );
     }
 
+    // Tuned and coupled tracks must keep their shape, plain ones can be polished later on
+    bool keepLinks = m_state == ROUTE_TRACK && m_mode == PNS_MODE_ROUTE_SINGLE;
+
     for( ITEM* item : added )
+    {
         m_iface->AddItem( item );
 
+        if( keepLinks && item->Kind() == ITEM::SEGMENT_T )
+            m_committedLinks.push_back( static_cast<LINKED_ITEM*>( item ) );
+    }
+
     for( ITEM* item : changed )
         m_iface->UpdateItem( item );
 
@@ -600,6 +675,240 @@ void ROUTER::CommitRouting( NODE* aNode )
 }
 
 
+bool ROUTER::OptimizeCommittedLines( int aTimeLimitMs )
+{
+    if( RoutingInProgress() || m_committedLinks.empty() )
+        return false;
+
+    std::vector<LINKED_ITEM*> seeds;
+    seeds.swap( m_committedLinks );
+
+    NODE*             branch = m_world->Branch();
+    std::vector<LINE> lines;
+
+    for( LINKED_ITEM* seed : seeds )
+    {
+        bool assembled = std::any_of( lines.begin(), lines.end(),
+                                      [&]( const LINE& aLine )
+                                      {
+                                          return aLine.ContainsLink( seed );
+                                      } );
+
+        if( assembled )
+            continue;
+
+        LINE line = branch->AssembleLine( seed, nullptr, true );
+
+        bool locked = std::any_of( line.Links().begin(), line.Links().end(),
+                                   []( const LINKED_ITEM* aLink )
+                                   {
+                                       return aLink->IsLocked();
+                                   } );
+
+        if( !locked )
+            lines.push_back( line );
+    }
+
+    std::vector<int> stages = { OPTIMIZER::MERGE_OBTUSE, OPTIMIZER::MERGE_SEGMENTS };
+
+    if( Settings().SmartPads() )
+        stages.push_back( OPTIMIZER::SMART_PADS );
+
+    TIME_LIMIT timeLimit( aTimeLimitMs );
+    int        effort = 0;
+    bool       changed = false;
+
+    for( int stage : stages )
+    {
+        effort |= stage;
+
+        OPTIMIZER optimizer( branch );
+        optimizer.SetEffortLevel( effort );
+        optimizer.SetCollisionMask( ITEM::ANY_T );
+
+        for( LINE& line : lines )
+        {
+            if( timeLimit.Expired() )
+                break;
+
+            LINE optimized;
+
+            if( !optimizer.Optimize( &line, &optimized ) )
+                continue;
+
+            branch->Replace( line, optimized );
+            line = optimized;
+            changed = true;
+        }
+    }
+
+    if( changed )
+        CommitRouting( branch );
+    else
+        delete branch;
+
+    return changed;
+}
+
+
+/**
+ * A track or differential pair tuned by ROUTER::TuneLengths().
+ */
+struct TUNED_MEMBER
+{
+    LINKED_ITEM*                         m_startItem = nullptr;
+    VECTOR2I                             m_start;
+    VECTOR2I                             m_end;
+    LINE::LINKS                          m_origin;     ///< Segments replaced by the meanders
+    std::unique_ptr<MEANDER_PLACER_BASE> m_placer;
+    DEBUG_DECORATOR                      m_dbg;        ///< Not shared between threads
+    bool                                 m_moved = false;
+};
+
+
+int ROUTER::TuneLengths( const std::vector<ITEM*>& aItems, ROUTER_MODE aMode,
+                         const MEANDER_SETTINGS& aSettings )
+{
+    if( RoutingInProgress() )
+        return 0;
+
+    if( aMode != PNS_MODE_TUNE_SINGLE && aMode != PNS_MODE_TUNE_DIFF_PAIR )
+        return 0;
+
+    m_committedLinks.clear();
+
+    auto startTuning =
+            [&]( TUNED_MEMBER& aMember, NODE* aBaseNode )
+            {
+                if( aMode == PNS_MODE_TUNE_SINGLE )
+                    aMember.m_placer = std::make_unique<MEANDER_PLACER>( this );
+                else
+                    aMember.m_placer = std::make_unique<DP_MEANDER_PLACER>( this );
+
+                aMember.m_placer->SetBaseNode( aBaseNode );
+                aMember.m_placer->UpdateSizes( m_sizes );
+                aMember.m_placer->UpdateSettings( aSettings );
+                aMember.m_placer->SetDebugDecorator( &aMember.m_dbg );
+
+                return aMember.m_placer->Start( aMember.m_start, aMember.m_startItem );
+            };
+
+    std::vector<std::unique_ptr<TUNED_MEMBER>> members;
+    std::set<int>                              nets;
+    TOPOLOGY                                   topo( m_world.get() );
+
+    // Branching a node is not thread safe, so the placers are all started here.  Each one
+    // is dragged from one end of its track to the other.
+    for( ITEM* item : aItems )
+    {
+        if( !item->OfKind( ITEM::SEGMENT_T | ITEM::ARC_T ) || nets.count( item->Net() ) )
+            continue;
+
+        LINKED_ITEM* seed = static_cast<LINKED_ITEM*>( item );
+        auto         member = std::make_unique<TUNED_MEMBER>();
+        LINE         guide;
+
+        if( aMode == PNS_MODE_TUNE_SINGLE )
+        {
+            guide = m_world->AssembleLine( seed );
+            member->m_origin = guide.Links();
+            nets.insert( guide.Net() );
+        }
+        else
+        {
+            DIFF_PAIR pair;
+
+            if( !topo.AssembleDiffPair( seed, pair ) )
+                continue;
+
+            guide = pair.PLine();
+            member->m_origin = pair.PLine().Links();
+            member->m_origin.insert( member->m_origin.end(), pair.NLine().Links().begin(),
+                                     pair.NLine().Links().end() );
+            nets.insert( pair.NetP() );
+            nets.insert( pair.NetN() );
+        }
+
+        if( !guide.LinkCount() )
+            continue;
+
+        member->m_startItem = guide.GetLink( 0 );
+        member->m_start = guide.CPoint( 0 );
+        member->m_end = guide.CPoint( -1 );
+
+        if( startTuning( *member, nullptr ) )
+            members.push_back( std::move( member ) );
+    }
+
+    THREAD_POOL::GetInstance().ParallelFor( members.size(),
+            [&]( size_t aIndex )
+            {
+                TUNED_MEMBER& member = *members[aIndex];
+
+                member.m_moved = member.m_placer->Move( member.m_end, nullptr );
+            } );
+
+    // The members were tuned without seeing each other's meanders
+    NODE* merged = m_world->Branch();
+    int   tunedCount = 0;
+    bool  changed = false;
+
+    auto fits =
+            [&]( const TUNED_MEMBER& aMember )
+            {
+                NODE* trial = merged->Branch();
+
+                for( LINKED_ITEM* link : aMember.m_origin )
+                    trial->Remove( link );
+
+                bool collides = !!trial->CheckColliding( aMember.m_placer->Traces() );
+
+                delete trial;
+                return !collides;
+            };
+
+    for( std::unique_ptr<TUNED_MEMBER>& member : members )
+    {
+        if( member->m_moved && !fits( *member ) )
+        {
+            // The branches of the first attempt are not needed any more
+            member->m_placer->ReleaseBranches();
+
+            member->m_moved = startTuning( *member, merged )
+                              && member->m_placer->Move( member->m_end, nullptr );
+        }
+
+        MEANDER_PLACER_BASE* placer = member->m_placer.get();
+
+        if( !member->m_moved || placer->TuningStatus() == MEANDER_PLACER_BASE::TOO_LONG )
+            continue;
+
+        ITEM_SET traces = placer->Traces();
+
+        for( LINKED_ITEM* link : member->m_origin )
+            merged->Remove( link );
+
+        for( const ITEM* trace : traces.CItems() )
+        {
+            LINE tuned( *static_cast<const LINE*>( trace ) );
+            merged->Add( tuned );
+        }
+
+        if( placer->TuningStatus() == MEANDER_PLACER_BASE::TUNED )
+            tunedCount++;
+
+        changed = true;
+    }
+
+    if( changed )
+        CommitRouting( merged );
+    else
+        m_world->KillChildren();
+
+    return tunedCount;
+}
+
+
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
     bool rv = false;
@@ -660,6 +969,9 @@ void ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    if( m_logger )
+        m_logger->Log( LOGGER::EVT_ABORT, m_currentEnd );
+
     m_placer.reset();
     m_dragger.reset();
 
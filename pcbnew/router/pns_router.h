@@ -25,6 +25,7 @@
 #include <list>
 
 #include <memory>
+#include <unordered_set>
 #include <core/optional.h>
 #include <boost/unordered_set.hpp>
 
@@ -52,6 +53,7 @@ class NODE;
 class DIFF_PAIR_PLACER;
 class PLACEMENT_ALGO;
 class LINE_PLACER;
+class MEANDER_SETTINGS;
 class ITEM;
 class ARC;
 class LINE;
@@ -96,6 +98,22 @@ enum DRAG_MODE
     virtual ~ROUTER_IFACE() {};
 
     virtual void SyncWorld( NODE* aNode ) = 0;
+
+    /**
+     * Bring \a aNode, a world built by SyncWorld(), up to date with the board.
+     *
+     * Only the listed items are looked at.  Footprints are converted as a whole, so changes to
+     * their children must be reported as changes of the footprint.
+     *
+     * @param aChangedItems are the items added to the board or modified, all still on it.
+     * @param aRemovedItems are the items removed from the board.  They are only used as keys,
+     *                      so they may be deleted already.
+     */
+    virtual void UpdateWorld( NODE* aNode, const std::unordered_set<BOARD_ITEM*>& aChangedItems,
+                              const std::unordered_set<const BOARD_ITEM*>& aRemovedItems ) = 0;
+
+    /// @return true if \a aNode holds the same items as a world synchronized from scratch.
+    virtual bool CheckWorld( NODE* aNode ) = 0;
     virtual void AddItem( ITEM* aItem ) = 0;
     virtual void UpdateItem( ITEM* aItem ) = 0;
     virtual void RemoveItem( ITEM* aItem ) = 0;
@@ -137,9 +155,22 @@ public:
 
     static ROUTER* GetInstance();
 
+    ///< Make \a aRouter the instance drawn on by the router algorithms, as when it was created.
+    static void SetInstance( ROUTER* aRouter );
+
     void ClearWorld();
     void SyncWorld();
 
+    /**
+     * Update the world after board changes, instead of synchronizing it from scratch.
+     *
+     * @param aChangedItems are the board items added or modified since the world was synced.
+     * @param aRemovedItems are the board items removed since then, possibly deleted already.
+     * @see ROUTER_IFACE::UpdateWorld()
+     */
+    void UpdateWorld( const std::unordered_set<BOARD_ITEM*>& aChangedItems,
+                      const std::unordered_set<const BOARD_ITEM*>& aRemovedItems );
+
     bool RoutingInProgress() const;
     bool StartRouting( const VECTOR2I& aP, ITEM* aItem, int aLayer );
     void Move( const VECTOR2I& aP, ITEM* aItem );
@@ -195,6 +226,31 @@ public:
 
     void CommitRouting( NODE* aNode );
 
+    /**
+     * Optimize the tracks added by the last single track routing and commit the result on its
+     * own, so that it can be undone separately.
+     *
+     * The cheaper optimizations are applied to all of the tracks before the more expensive
+     * ones, so that whatever has been improved when \a aTimeLimitMs runs out is worth keeping.
+     *
+     * @return true if any track was changed.
+     */
+    bool OptimizeCommittedLines( int aTimeLimitMs );
+
+    /**
+     * Tune the lengths of several tracks or differential pairs to the target of \a aSettings
+     * and commit all of them at once.
+     *
+     * The members are meandered concurrently, each on its own branch of the world.  A member
+     * whose meanders collide with the ones of the members before it is tuned again around them.
+     *
+     * @param aItems are segments or arcs of the tracks to tune, one per net is enough.
+     * @param aMode is PNS_MODE_TUNE_SINGLE or PNS_MODE_TUNE_DIFF_PAIR.
+     * @return the number of members that reached the target length.
+     */
+    int TuneLengths( const std::vector<ITEM*>& aItems, ROUTER_MODE aMode,
+                     const MEANDER_SETTINGS& aSettings );
+
     /**
      * Applies stored settings.
      * @see Settings()
@@ -245,6 +301,8 @@ private:
 
     ROUTER_IFACE*     m_iface;
 
+    std::vector<LINKED_ITEM*> m_committedLinks;   ///< Segments added by the last routing
+
     int               m_iterLimit;
     bool              m_showInterSteps;
     int               m_snapshotIter;
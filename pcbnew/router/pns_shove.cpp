@@ -1257,6 +1257,7 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
         st = shoveIteration( m_iter );
 
         m_iter++;
+        PERF_COUNTERS::Instance().m_ShoveIterations.fetch_add( 1, std::memory_order_relaxed );
 
         if( st == SH_INCOMPLETE || timeLimit.Expired() || m_iter >= iterLimit )
         {
@@ -83,17 +83,15 @@ static const SHAPE_LINE_CHAIN buildHullForPrimitiveShape( const SHAPE* aShape, i
 }
 
 
-const SHAPE_LINE_CHAIN SOLID::Hull( int aClearance, int aWalkaroundThickness, int aLayer ) const
+static const SHAPE_LINE_CHAIN buildHull( const SHAPE* aShape, int aClearance,
+                                         int aWalkaroundThickness )
 {
-    if( !ROUTER::GetInstance()->GetInterface()->IsFlashedOnLayer( this, aLayer ) )
-        return HoleHull( aClearance, aWalkaroundThickness, aLayer );
-
-    if( !m_shape )
+    if( !aShape )
         return SHAPE_LINE_CHAIN();
 
-    if( m_shape->Type() == SH_COMPOUND )
+    if( aShape->Type() == SH_COMPOUND )
     {
-        SHAPE_COMPOUND* cmpnd = static_cast<SHAPE_COMPOUND*>( m_shape );
+        const SHAPE_COMPOUND* cmpnd = static_cast<const SHAPE_COMPOUND*>( aShape );
 
         if ( cmpnd->Shapes().size() == 1 )
         {
@@ -109,36 +107,31 @@ const SHAPE_LINE_CHAIN SOLID::Hull( int aClearance, int aWalkaroundThickness, in
     }
     else
     {
-        return buildHullForPrimitiveShape( m_shape, aClearance, aWalkaroundThickness );
+        return buildHullForPrimitiveShape( aShape, aClearance, aWalkaroundThickness );
     }
 }
 
 
-const SHAPE_LINE_CHAIN SOLID::HoleHull( int aClearance, int aWalkaroundThickness, int aLayer ) const
+const SHAPE_LINE_CHAIN SOLID::Hull( int aClearance, int aWalkaroundThickness, int aLayer ) const
 {
-    if( !m_hole )
-        return SHAPE_LINE_CHAIN();
+    if( !ROUTER::GetInstance()->GetInterface()->IsFlashedOnLayer( this, aLayer ) )
+        return HoleHull( aClearance, aWalkaroundThickness, aLayer );
 
-    if( m_hole->Type() == SH_COMPOUND )
-    {
-        SHAPE_COMPOUND* cmpnd = static_cast<SHAPE_COMPOUND*>( m_hole );
+    return m_hulls.Get( aClearance, aWalkaroundThickness, false,
+                        [&]()
+                        {
+                            return buildHull( m_shape, aClearance, aWalkaroundThickness );
+                        } );
+}
 
-        if ( cmpnd->Shapes().size() == 1 )
-        {
-            return buildHullForPrimitiveShape( cmpnd->Shapes()[0], aClearance,
-                                               aWalkaroundThickness );
-        }
-        else
-        {
-            // fixme - shouldn't happen but one day we should move
-            // TransformShapeWithClearanceToPolygon() to the Geometry Library
-            return SHAPE_LINE_CHAIN();
-        }
-    }
-    else
-    {
-        return buildHullForPrimitiveShape( m_hole, aClearance, aWalkaroundThickness );
-    }
+
+const SHAPE_LINE_CHAIN SOLID::HoleHull( int aClearance, int aWalkaroundThickness, int aLayer ) const
+{
+    return m_hulls.Get( aClearance, aWalkaroundThickness, true,
+                        [&]()
+                        {
+                            return buildHull( m_hole, aClearance, aWalkaroundThickness );
+                        } );
 }
 
 
@@ -156,6 +149,7 @@ void SOLID::SetPos( const VECTOR2I& aCenter )
         m_shape->Move( delta );
 
     m_pos = aCenter;
+    m_hulls.Clear();
 }
 
 
@@ -28,6 +28,7 @@
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 
+#include "pns_hull_cache.h"
 #include "pns_item.h"
 
 namespace PNS {
@@ -90,12 +91,14 @@ public:
     {
         delete m_shape;
         m_shape = shape;
+        m_hulls.Clear();
     }
 
     void SetHole( SHAPE* shape )
     {
         delete m_hole;
         m_hole = shape;
+        m_hulls.Clear();
     }
 
     const VECTOR2I& Pos() const { return m_pos; }
@@ -127,6 +130,7 @@ private:
     VECTOR2I    m_offset;
     int         m_padToDie;
     double      m_orientation;  // in 1/10 degrees, matching PAD
+    HULL_CACHE  m_hulls;
 };
 
 }
@@ -57,6 +57,8 @@ TOOL_BASE::TOOL_BASE( const std::string& aToolName ) :
     m_gridHelper = nullptr;
     m_iface = nullptr;
     m_router = nullptr;
+    m_listenedBoard = nullptr;
+    m_syncedUnnotifiedChanges = 0;
     m_cancelled = false;
 
     m_startItem = nullptr;
@@ -71,6 +73,9 @@ TOOL_BASE::TOOL_BASE( const std::string& aToolName ) :
 
 TOOL_BASE::~TOOL_BASE()
 {
+    if( m_listenedBoard )
+        m_listenedBoard->RemoveListener( this );
+
     delete m_gridHelper;
     delete m_iface;
     delete m_router;
@@ -80,19 +85,47 @@ TOOL_BASE::~TOOL_BASE()
 void TOOL_BASE::Reset( RESET_REASON aReason )
 {
     delete m_gridHelper;
-    delete m_iface;
-    delete m_router;
 
-    m_iface = new PNS_KICAD_IFACE;
-    m_iface->SetBoard( board() );
-    m_iface->SetView( getView() );
-    m_iface->SetHostTool( this );
-    m_iface->SetDisplayOptions( &( frame()->GetDisplayOptions() ) );
+    // Starting a tool again on the same board only needs the items changed in the meantime
+    if( aReason == RUN && m_router && m_listenedBoard == board() )
+    {
+        // Other router tools may have created their routers since
+        ROUTER::SetInstance( m_router );
+
+        // The debug log covers a single invocation
+        m_router->Logger()->Clear();
 
-    m_router = new ROUTER;
-    m_router->SetInterface( m_iface );
-    m_router->ClearWorld();
-    m_router->SyncWorld();
+        syncWorld();
+    }
+    else
+    {
+        delete m_iface;
+        delete m_router;
+
+        m_iface = new PNS_KICAD_IFACE;
+        m_iface->SetBoard( board() );
+        m_iface->SetView( getView() );
+        m_iface->SetHostTool( this );
+        m_iface->SetDisplayOptions( &( frame()->GetDisplayOptions() ) );
+
+        m_router = new ROUTER;
+        m_router->SetInterface( m_iface );
+        m_router->ClearWorld();
+        m_router->SyncWorld();
+
+        m_changedItems.clear();
+        m_removedItems.clear();
+        m_syncedUnnotifiedChanges = board()->GetUnnotifiedChanges();
+    }
+
+    if( m_listenedBoard != board() )
+    {
+        if( m_listenedBoard )
+            m_listenedBoard->RemoveListener( this );
+
+        m_listenedBoard = board();
+        m_listenedBoard->AddListener( this );
+    }
 
     m_router->UpdateSizes( m_savedSizes );
 
@@ -107,6 +140,101 @@ void TOOL_BASE::Reset( RESET_REASON aReason )
 }
 
 
+void TOOL_BASE::itemChanged( BOARD_ITEM* aItem )
+{
+    // The world converts footprints as a whole
+    BOARD_ITEM* parent = aItem->GetParent();
+
+    if( parent && parent->Type() == PCB_FOOTPRINT_T )
+        aItem = parent;
+
+    m_removedItems.erase( aItem );
+    m_changedItems.insert( aItem );
+}
+
+
+void TOOL_BASE::itemRemoved( BOARD_ITEM* aItem )
+{
+    BOARD_ITEM* parent = aItem->GetParent();
+
+    if( parent && parent->Type() == PCB_FOOTPRINT_T )
+    {
+        itemChanged( parent );
+        return;
+    }
+
+    m_changedItems.erase( aItem );
+    m_removedItems.insert( aItem );
+}
+
+
+void TOOL_BASE::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aItem )
+{
+    itemChanged( aItem );
+}
+
+
+void TOOL_BASE::OnBoardItemsAdded( BOARD& aBoard, std::vector<BOARD_ITEM*>& aItems )
+{
+    for( BOARD_ITEM* item : aItems )
+        itemChanged( item );
+}
+
+
+void TOOL_BASE::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aItem )
+{
+    itemChanged( aItem );
+}
+
+
+void TOOL_BASE::OnBoardItemsChanged( BOARD& aBoard, std::vector<BOARD_ITEM*>& aItems )
+{
+    for( BOARD_ITEM* item : aItems )
+        itemChanged( item );
+}
+
+
+void TOOL_BASE::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aItem )
+{
+    itemRemoved( aItem );
+}
+
+
+void TOOL_BASE::OnBoardItemsRemoved( BOARD& aBoard, std::vector<BOARD_ITEM*>& aItems )
+{
+    for( BOARD_ITEM* item : aItems )
+        itemRemoved( item );
+}
+
+
+void TOOL_BASE::OnBoardDeleted( BOARD& aBoard )
+{
+    // The next Reset() starts over with the new board
+    if( &aBoard == m_listenedBoard )
+    {
+        m_listenedBoard = nullptr;
+        m_changedItems.clear();
+        m_removedItems.clear();
+    }
+}
+
+
+void TOOL_BASE::syncWorld()
+{
+    unsigned unnotifiedChanges = board()->GetUnnotifiedChanges();
+
+    // The changes made behind the listeners' back are unknown: start over
+    if( unnotifiedChanges != m_syncedUnnotifiedChanges )
+        m_router->SyncWorld();
+    else
+        m_router->UpdateWorld( m_changedItems, m_removedItems );
+
+    m_changedItems.clear();
+    m_removedItems.clear();
+    m_syncedUnnotifiedChanges = unnotifiedChanges;
+}
+
+
 ITEM* TOOL_BASE::pickSingleItem( const VECTOR2I& aWhere, int aNet, int aLayer, bool aIgnorePads,
 								 const std::vector<ITEM*> aAvoidItems )
 {
@@ -24,6 +24,7 @@
 #define __PNS_TOOL_BASE_H
 
 #include <memory>
+#include <unordered_set>
 #include <import_export.h>
 
 #include <math/vector2d.h>
@@ -41,7 +42,7 @@ class PNS_TUNE_STATUS_POPUP;
 
 namespace PNS {
 
-class APIEXPORT TOOL_BASE : public PCB_TOOL_BASE
+class APIEXPORT TOOL_BASE : public PCB_TOOL_BASE, public BOARD_LISTENER
 {
 public:
     TOOL_BASE( const std::string& aToolName );
@@ -51,7 +52,22 @@ public:
 
     ROUTER* Router() const;
 
+    ///< The router world is kept between invocations; these record what it misses.
+    void OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aItem ) override;
+    void OnBoardItemsAdded( BOARD& aBoard, std::vector<BOARD_ITEM*>& aItems ) override;
+    void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aItem ) override;
+    void OnBoardItemsChanged( BOARD& aBoard, std::vector<BOARD_ITEM*>& aItems ) override;
+    void OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aItem ) override;
+    void OnBoardItemsRemoved( BOARD& aBoard, std::vector<BOARD_ITEM*>& aItems ) override;
+    void OnBoardDeleted( BOARD& aBoard ) override;
+
 protected:
+    ///< Bring the router world up to date with the board changes made since the last sync.
+    void syncWorld();
+
+    void itemChanged( BOARD_ITEM* aItem );
+    void itemRemoved( BOARD_ITEM* aItem );
+
     bool checkSnap( ITEM* aItem );
 
     const VECTOR2I snapToItem( ITEM* aSnapToItem, VECTOR2I aP);
@@ -78,6 +94,19 @@ protected:
     ROUTER*          m_router;
 
     bool             m_cancelled;
+
+    ///< Board items added or modified since the router world was synced, all on the board.
+    ///< Footprints stand for their children.
+    std::unordered_set<BOARD_ITEM*>       m_changedItems;
+
+    ///< Board items removed since the router world was synced.  They may be deleted already.
+    std::unordered_set<const BOARD_ITEM*> m_removedItems;
+
+    ///< BOARD::GetUnnotifiedChanges() when the router world was synced
+    unsigned         m_syncedUnnotifiedChanges;
+
+    ///< The board the tool is registered with as a listener, null once it has been deleted.
+    BOARD*           m_listenedBoard;
 };
 
 }
@@ -32,12 +32,33 @@
 
 namespace PNS {
 
+/**
+ * Make a closed hull of \a aCount points, clockwise.  \a aPoints are reversed if the point
+ * \a aInside lies on the wrong side of their first edge.
+ */
+static const SHAPE_LINE_CHAIN clockwiseHull( const VECTOR2I* aPoints, size_t aCount,
+                                             const VECTOR2I& aInside )
+{
+    SHAPE_LINE_CHAIN s;
+    bool             reverse = SEG( aPoints[0], aPoints[1] ).Side( aInside ) < 0;
+
+    s.SetClosed( true );
+    s.Reserve( aCount );
+
+    for( size_t i = 0; i < aCount; i++ )
+        s.Append( aPoints[reverse ? aCount - 1 - i : i] );
+
+    return s;
+}
+
+
 const SHAPE_LINE_CHAIN OctagonalHull( const VECTOR2I& aP0, const VECTOR2I& aSize,
                                       int aClearance, int aChamfer )
 {
     SHAPE_LINE_CHAIN s;
 
     s.SetClosed( true );
+    s.Reserve( 8 );
 
     s.Append( aP0.x - aClearance, aP0.y - aClearance + aChamfer );
     s.Append( aP0.x - aClearance + aChamfer, aP0.y - aClearance );
@@ -60,9 +81,10 @@ const SHAPE_LINE_CHAIN ArcHull( const SHAPE_ARC& aSeg, int aClearance,
 
     auto line = aSeg.ConvertToPolyline();
 
-    SHAPE_LINE_CHAIN s;
-    s.SetClosed( true );
-    std::vector<VECTOR2I> reverse_line;
+    // One side of the arc forwards, the other one backwards and a cap on either end
+    std::vector<VECTOR2I> points( 8 + 2 * ( line.SegmentCount() - 1 ) );
+    size_t                front = 0;
+    size_t                back = points.size();
 
     auto seg = line.Segment( 0 );
     VECTOR2I dir = seg.B - seg.A;
@@ -72,10 +94,10 @@ const SHAPE_LINE_CHAIN ArcHull( const SHAPE_ARC& aSeg, int aClearance,
     VECTOR2I dp = dir.Resize( d );
 
     // Append the first curve
-    s.Append( seg.A + p0 - pd );
-    s.Append( seg.A - dp + ds );
-    s.Append( seg.A - dp - ds );
-    s.Append( seg.A - p0 - pd );
+    points[front++] = seg.A + p0 - pd;
+    points[front++] = seg.A - dp + ds;
+    points[front++] = seg.A - dp - ds;
+    points[front++] = seg.A - p0 - pd;
 
     for( int i = 1; i < line.SegmentCount(); i++ )
     {
@@ -87,25 +109,19 @@ const SHAPE_LINE_CHAIN ArcHull( const SHAPE_ARC& aSeg, int aClearance,
         auto dir2 = old_seg.A - seg.B;
 
         p0 = dir2.Perpendicular().Resize( d );
-        s.Append( seg.A - p0 );
-        reverse_line.push_back( seg.A + p0 );
+        points[front++] = seg.A - p0;
+        points[--back] = seg.A + p0;
     }
 
     pd = dir.Resize( x );
     dp = dir.Resize( d );
-    s.Append( seg.B - p0 + pd );
-    s.Append( seg.B + dp - ds );
-    s.Append( seg.B + dp + ds );
-    s.Append( seg.B + p0 + pd );
-
-    for( int i = reverse_line.size() - 1; i >= 0; i-- )
-        s.Append( reverse_line[i] );
+    points[front++] = seg.B - p0 + pd;
+    points[front++] = seg.B + dp - ds;
+    points[front++] = seg.B + dp + ds;
+    points[front++] = seg.B + p0 + pd;
 
     // make sure the hull outline is always clockwise
-    if( s.CSegment( 0 ).Side( line.Segment( 0 ).A ) < 0 )
-        return s.Reverse();
-    else
-        return s;
+    return clockwiseHull( points.data(), points.size(), line.Segment( 0 ).A );
 }
 
 
@@ -133,24 +149,11 @@ const SHAPE_LINE_CHAIN SegmentHull ( const SHAPE_SEGMENT& aSeg, int aClearance,
     VECTOR2I pd = dir.Resize( x / 2 );
     VECTOR2I dp = dir.Resize( d );
 
-    SHAPE_LINE_CHAIN s;
-
-    s.SetClosed( true );
-
-    s.Append( b + p0 + pd );
-    s.Append( b + dp + ds );
-    s.Append( b + dp - ds );
-    s.Append( b - p0 + pd );
-    s.Append( a - p0 - pd );
-    s.Append( a - dp - ds );
-    s.Append( a - dp + ds );
-    s.Append( a + p0 - pd );
+    const VECTOR2I points[] = { b + p0 + pd, b + dp + ds, b + dp - ds, b - p0 + pd,
+                                a - p0 - pd, a - dp - ds, a - dp + ds, a + p0 - pd };
 
     // make sure the hull outline is always clockwise
-    if( s.CSegment( 0 ).Side( a ) < 0 )
-        return s.Reverse();
-    else
-        return s;
+    return clockwiseHull( points, 8, a );
 }
 
 
@@ -208,6 +211,7 @@ const SHAPE_LINE_CHAIN ConvexHull( const SHAPE_SIMPLE& aConvex, int aClearance )
 
     SHAPE_LINE_CHAIN octagon;
     octagon.SetClosed( true );
+    octagon.Reserve( 8 );
 
     octagon.Append( *leftline.IntersectLines( bottomleftline ) );
     octagon.Append( *bottomline.IntersectLines( bottomleftline ) );
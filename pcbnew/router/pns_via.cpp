@@ -73,15 +73,17 @@ bool VIA::PushoutForce( NODE* aNode, const VECTOR2I& aDirection, VECTOR2I& aForc
 
 const SHAPE_LINE_CHAIN VIA::Hull( int aClearance, int aWalkaroundThickness, int aLayer ) const
 {
-    int cl = ( aClearance + aWalkaroundThickness / 2 );
-    int width = m_diameter;
-
-    if( !ROUTER::GetInstance()->GetInterface()->IsFlashedOnLayer( this, aLayer ) )
-        width = m_drill;
-
-    return OctagonalHull( m_pos -
-        VECTOR2I( width / 2, width / 2 ), VECTOR2I( width, width ),
-        cl + 1, ( 2 * cl + width ) * 0.26 );
+    int  cl = ( aClearance + aWalkaroundThickness / 2 );
+    bool flashed = ROUTER::GetInstance()->GetInterface()->IsFlashedOnLayer( this, aLayer );
+    int  width = flashed ? m_diameter : m_drill;
+
+    return m_hulls.Get( aClearance, aWalkaroundThickness, !flashed,
+                        [&]()
+                        {
+                            return OctagonalHull( m_pos - VECTOR2I( width / 2, width / 2 ),
+                                                  VECTOR2I( width, width ),
+                                                  cl + 1, ( 2 * cl + width ) * 0.26 );
+                        } );
 }
 
 
@@ -96,7 +98,7 @@ VIA* VIA::Clone() const
     v->m_drill = m_drill;
     v->m_shape = SHAPE_CIRCLE( m_pos, m_diameter / 2 );
     v->m_rank = m_rank;
-    v->m_marker = m_marker;
+    v->m_marker = m_marker.load();
     v->m_viaType = m_viaType;
     v->m_parent = m_parent;
     v->m_isFree = m_isFree;
@@ -28,6 +28,7 @@
 
 #include "track.h"
 
+#include "pns_hull_cache.h"
 #include "pns_item.h"
 
 namespace PNS {
@@ -81,7 +82,7 @@ public:
         m_diameter = aB.m_diameter;
         m_shape = SHAPE_CIRCLE( m_pos, m_diameter / 2 );
         m_hole = SHAPE_CIRCLE( m_pos, aB.m_drill / 2 );
-        m_marker = aB.m_marker;
+        m_marker = aB.m_marker.load();
         m_rank = aB.m_rank;
         m_drill = aB.m_drill;
         m_viaType = aB.m_viaType;
@@ -99,6 +100,7 @@ public:
     {
         m_pos = aPos;
         m_shape.SetCenter( aPos );
+        m_hulls.Clear();
     }
 
     VIATYPE ViaType() const { return m_viaType; }
@@ -110,10 +112,16 @@ public:
     {
         m_diameter = aDiameter;
         m_shape.SetRadius( m_diameter / 2 );
+        m_hulls.Clear();
     }
 
     int Drill() const { return m_drill; }
-    void SetDrill( int aDrill ) { m_drill = aDrill; }
+
+    void SetDrill( int aDrill )
+    {
+        m_drill = aDrill;
+        m_hulls.Clear();
+    }
 
     bool IsFree() const { return m_isFree; }
     void SetIsFree( bool aIsFree ) { m_isFree = aIsFree; }
@@ -153,6 +161,7 @@ private:
     SHAPE_CIRCLE m_hole;
     VIATYPE      m_viaType;
     bool         m_isFree;
+    HULL_CACHE   m_hulls;
 };
 
 }
@@ -19,7 +19,12 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <climits>
+
+#include <advanced_config.h>
 #include <core/optional.h>
+#include <core/thread_pool.h>
 
 #include <geometry/shape_line_chain.h>
 
@@ -57,6 +62,8 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 {
     OPT<OBSTACLE>& current_obs =
         aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
+    int& blockage_count =
+        aWindingDirection ? m_recursiveBlockageCount[0] : m_recursiveBlockageCount[1];
 
     if( !current_obs )
         return DONE;
@@ -69,9 +76,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
         if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
         {
-            m_recursiveBlockageCount++;
+            blockage_count++;
 
-            if( m_recursiveBlockageCount < 3 )
+            if( blockage_count < 3 )
                 aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
             else
             {
@@ -184,6 +191,133 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
 
 
+/**
+ * The state of the walk in one direction, when both directions are walked concurrently.
+ */
+struct WALKAROUND::DIRECTION_WALK
+{
+    struct SNAPSHOT
+    {
+        int               m_iteration;
+        WALKAROUND_STATUS m_status;
+        LINE              m_path;
+    };
+
+    DIRECTION_WALK( const LINE& aPath, WALKAROUND_STATUS aStatus ) :
+            m_path( aPath ),
+            m_status( aStatus ),
+            m_stableFrom( INT_MAX )
+    {}
+
+    /// @return true if the walk is known not to be in progress after iteration \a aIter.
+    bool Settled( int aIter ) const
+    {
+        if( aIter < (int) m_history.size() )
+            return m_history[aIter] != IN_PROGRESS;
+
+        return aIter >= m_stableFrom;
+    }
+
+    LINE                           m_path;
+    WALKAROUND_STATUS              m_status;
+    std::vector<WALKAROUND_STATUS> m_history;    ///< Status after each iteration
+    std::vector<SNAPSHOT>          m_snapshots;  ///< Paths of the iterations not in progress
+    std::atomic<int>               m_stableFrom; ///< Iteration from which nothing changes
+};
+
+
+void WALKAROUND::walkDirection( DIRECTION_WALK& aWalk, bool aWindingDirection,
+                                const DIRECTION_WALK& aOther )
+{
+    for( int i = 0; i < m_iterationLimit; i++ )
+    {
+        if( aWalk.m_status != STUCK )
+            aWalk.m_status = singleStep( aWalk.m_path, aWindingDirection );
+
+        if( clipToLoopStart( aWalk.m_path.Line() ) )
+            aWalk.m_status = ALMOST_DONE;
+
+        aWalk.m_history.push_back( aWalk.m_status );
+
+        if( aWalk.m_status == IN_PROGRESS )
+            continue;
+
+        aWalk.m_snapshots.push_back( { i, aWalk.m_status, aWalk.m_path } );
+
+        // A finished or stuck walk stays so; an almost done one may still go on
+        if( aWalk.m_status == DONE || aWalk.m_status == STUCK )
+        {
+            aWalk.m_stableFrom = i;
+            return;
+        }
+
+        // The interleaved walk would have stopped here already
+        if( aOther.m_stableFrom <= i )
+            return;
+    }
+}
+
+
+const WALKAROUND::RESULT WALKAROUND::walkConcurrently( const LINE& aInitialPath,
+                                                       WALKAROUND_STATUS aStatusCw,
+                                                       WALKAROUND_STATUS aStatusCcw )
+{
+    DIRECTION_WALK walks[2] = { { aInitialPath, aStatusCw }, { aInitialPath, aStatusCcw } };
+
+    THREAD_POOL::GetInstance().ParallelFor( 2,
+            [&]( size_t aDir )
+            {
+                walkDirection( walks[aDir], aDir == 0, walks[1 - aDir] );
+            } );
+
+    // The interleaved walk stops after the first iteration in which neither direction is
+    // in progress, so take the paths both directions had at that iteration.
+    int  last = m_iterationLimit - 1;
+    bool settled = false;
+
+    for( int i = 0; i < m_iterationLimit && !settled; i++ )
+    {
+        if( walks[0].Settled( i ) && walks[1].Settled( i ) )
+        {
+            last = i;
+            settled = true;
+        }
+    }
+
+    m_iteration = settled ? last : m_iterationLimit;
+
+    RESULT result;
+
+    result.lineCw = aInitialPath;
+    result.lineCcw = aInitialPath;
+
+    for( int dir = 0; dir < 2; dir++ )
+    {
+        const DIRECTION_WALK& walk = walks[dir];
+        LINE&                 line = dir == 0 ? result.lineCw : result.lineCcw;
+        WALKAROUND_STATUS&    status = dir == 0 ? result.statusCw : result.statusCcw;
+
+        if( !walk.Settled( last ) )
+        {
+            line = walk.m_path;
+            status = ALMOST_DONE;
+            continue;
+        }
+
+        for( const DIRECTION_WALK::SNAPSHOT& snapshot : walk.m_snapshots )
+        {
+            if( snapshot.m_iteration > last )
+                break;
+
+            line = snapshot.m_path;
+            status = snapshot.m_status;
+        }
+    }
+
+    return result;
+}
+
+
 const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 {
     LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
@@ -203,7 +337,7 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
     start( aInitialPath );
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
 
     result.lineCw = aInitialPath;
     result.lineCcw = aInitialPath;
@@ -217,51 +351,65 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
+    const ADVANCED_CFG& cfg = ADVANCED_CFG::GetCfg();
+
+    // The debug graphics are drawn into the view, which must not happen from other threads
+    bool concurrent = cfg.m_RouterParallelWalkaround && !cfg.m_ShowRouterDebugGraphics
+                      && m_iterationLimit > 0
+                      && THREAD_POOL::GetInstance().GetThreadCount() > 0;
+
+    if( concurrent )
     {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+        result = walkConcurrently( aInitialPath, s_cw, s_ccw );
+    }
+    else
+    {
+        while( m_iteration < m_iterationLimit )
+        {
+            if( s_cw != STUCK )
+                s_cw = singleStep( path_cw, true );
 
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+            if( s_ccw != STUCK )
+                s_ccw = singleStep( path_ccw, false );
 
-        auto old = path_cw.CLine();
+            auto old = path_cw.CLine();
 
-        if( clipToLoopStart( path_cw.Line() ) )
-            s_cw = ALMOST_DONE;
+            if( clipToLoopStart( path_cw.Line() ) )
+                s_cw = ALMOST_DONE;
 
-        if( clipToLoopStart( path_ccw.Line() ) )
-            s_ccw = ALMOST_DONE;
+            if( clipToLoopStart( path_ccw.Line() ) )
+                s_ccw = ALMOST_DONE;
 
 
-        if( s_cw != IN_PROGRESS )
+            if( s_cw != IN_PROGRESS )
+            {
+                result.lineCw = path_cw;
+                result.statusCw = s_cw;
+            }
+
+            if( s_ccw != IN_PROGRESS )
+            {
+                result.lineCcw = path_ccw;
+                result.statusCcw = s_ccw;
+            }
+
+            if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
+                break;
+
+            m_iteration++;
+        }
+
+        if( s_cw == IN_PROGRESS )
         {
             result.lineCw = path_cw;
-            result.statusCw = s_cw;
+            result.statusCw = ALMOST_DONE;
         }
 
-        if( s_ccw != IN_PROGRESS )
+        if( s_ccw == IN_PROGRESS )
         {
             result.lineCcw = path_ccw;
-            result.statusCcw = s_ccw;
+            result.statusCcw = ALMOST_DONE;
         }
-
-        if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
-            break;
-
-        m_iteration++;
-    }
-
-    if( s_cw == IN_PROGRESS )
-    {
-        result.lineCw = path_cw;
-        result.statusCw = ALMOST_DONE;
-    }
-
-    if( s_ccw == IN_PROGRESS )
-    {
-        result.lineCcw = path_ccw;
-        result.statusCcw = ALMOST_DONE;
     }
 
     result.lineCw.Line().Simplify();
@@ -312,7 +460,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
     start( aInitialPath );
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
 
     aWalkPath = aInitialPath;
 
@@ -49,7 +49,7 @@ public:
         m_itemMask = ITEM::ANY_T;
 
         // Initialize other members, to avoid uninitialized variables.
-        m_recursiveBlockageCount = 0;
+        m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
@@ -140,14 +140,25 @@ public:
     const RESULT Route( const LINE& aInitialPath );
 
 private:
+    struct DIRECTION_WALK;
+
     void start( const LINE& aInitialPath );
 
     WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
+    /**
+     * Walk around the obstacles in both directions on separate threads.  The result is the
+     * same as the one of the interleaved walk in Route().
+     */
+    const RESULT walkConcurrently( const LINE& aInitialPath, WALKAROUND_STATUS aStatusCw,
+                                   WALKAROUND_STATUS aStatusCcw );
+    void walkDirection( DIRECTION_WALK& aWalk, bool aWindingDirection,
+                        const DIRECTION_WALK& aOther );
+
     NODE* m_world;
 
-    int m_recursiveBlockageCount;
+    int m_recursiveBlockageCount[2];
     int m_iteration;
     int m_iterationLimit;
     int m_itemMask;
@@ -34,6 +34,7 @@ using namespace std::placeholders;
 #include <dialogs/dialog_pns_diff_pair_dimensions.h>
 #include <dialogs/dialog_track_via_size.h>
 #include <widgets/infobar.h>
+#include <advanced_config.h>
 #include <confirm.h>
 #include <bitmaps.h>
 #include <tool/action_menu.h>
@@ -73,6 +74,10 @@ enum VIA_ACTION_FLAGS
 };
 
 
+/// Time the deferred optimization of routed tracks may block the editor for
+static const int DEFERRED_OPTIMIZATION_TIME_MS = 100;
+
+
 // Actions, being statically-defined, require specialized I18N handling.  We continue to
 // use the _() macro so that string harvesting by the I18N framework doesn't have to be
 // specialized, but we don't translate on initialization and instead do it in the getters.
@@ -495,23 +500,9 @@ void ROUTER_TOOL::handleCommonEvents( const TOOL_EVENT& aEvent )
             if( ! logger )
                 return;
 
-            FILE *f = fopen("/tmp/pns.log", "wb");
             wxLogTrace( "PNS", "saving drag/route log...\n" );
 
-            const auto& events = logger->GetEvents();
-
-            for( auto evt : events)
-            {
-                wxString id = "null";
-
-                if( evt.item && evt.item->Parent() )
-                    id = evt.item->Parent()->m_Uuid.AsString();
-
-                fprintf( f, "event %d %d %d %s\n", evt.p.x, evt.p.y, evt.type,
-                         (const char*) id.c_str() );
-            }
-
-            fclose( f );
+            logger->Save( "/tmp/pns.log" );
 
             // Export as *.kicad_pcb format, using a strategy which is specifically chosen
             // as an example on how it could also be used to send it to the system clipboard.
@@ -1131,6 +1122,17 @@ void ROUTER_TOOL::performRouting()
     m_router->StopRouting();
 
     finishInteractive();
+
+    if( ADVANCED_CFG::GetCfg().m_RouterDeferredOptimization )
+    {
+        // Let the editor catch up with the committed tracks first
+        frame()->CallAfter(
+                [this]()
+                {
+                    if( m_router->OptimizeCommittedLines( DEFERRED_OPTIMIZATION_TIME_MS ) )
+                        frame()->GetCanvas()->Refresh();
+                } );
+    }
 }
 
 
@@ -1251,13 +1253,11 @@ int ROUTER_TOOL::MainLoop( const TOOL_EVENT& aEvent )
                 break;
             }
         }
-        else if( evt->Action() == TA_UNDO_REDO_PRE )
-        {
-            m_router->ClearWorld();
-        }
         else if( evt->Action() == TA_UNDO_REDO_POST || evt->Action() == TA_MODEL_CHANGE )
         {
-            m_router->SyncWorld();
+            // The world is not looked at while the undo runs, its stale items are only
+            // compared by address
+            syncWorld();
         }
         else if( evt->IsMotion() )
         {
@@ -1514,7 +1514,7 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+    syncWorld();
     m_startItem = nullptr;
 
     PNS::ITEM* startItem = nullptr;
@@ -1729,7 +1729,7 @@ int ROUTER_TOOL::InlineBreakTrack( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+    syncWorld();
     m_startItem = m_router->GetWorld()->FindItemByParent( item );
 
     TOOL_MANAGER* toolManager = frame()->GetToolManager();
@@ -28,6 +28,11 @@
 // this shared_ptr line has to be before include connectivity_data.h.
 %shared_ptr(CONNECTIVITY_DATA)
 
+// CN_NET_STATS::m_ViaSpans, as returned by CONNECTIVITY_DATA::GetNetStats()
+%include <std_pair.i>
+%template(LAYER_ID_PAIR) std::pair<PCB_LAYER_ID, PCB_LAYER_ID>;
+%template(MAP_LAYER_ID_PAIR_UINT) std::map<std::pair<PCB_LAYER_ID, PCB_LAYER_ID>, unsigned int>;
+
 %include connectivity/connectivity_data.h
 
  
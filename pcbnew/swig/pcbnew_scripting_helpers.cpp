@@ -321,6 +321,9 @@ void Refresh()
         auto board = s_PcbEditFrame->GetBoard();
         board->BuildConnectivity();
 
+        // Scripts edit items in place, so tools keeping copies of them have to start over
+        board->OnUnnotifiedChanges();
+
         // Re-init everything: this is the easy way to do that
         s_PcbEditFrame->ActivateGalCanvas();
         s_PcbEditFrame->GetCanvas()->Refresh();
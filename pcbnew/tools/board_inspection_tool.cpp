@@ -54,7 +54,14 @@ BOARD_INSPECTION_TOOL::BOARD_INSPECTION_TOOL() :
 {
     m_probingSchToPcb = false;
     m_lastNetcode = -1;
-    m_dynamicData = nullptr;
+}
+
+
+BOARD_INSPECTION_TOOL::~BOARD_INSPECTION_TOOL()
+{
+    // The dynamic ratsnest worker reports back to this tool
+    if( m_dynamicBoardConnectivity )
+        m_dynamicBoardConnectivity->WaitForDynamicRatsnest();
 }
 
 
@@ -1045,8 +1052,7 @@ int BOARD_INSPECTION_TOOL::UpdateSelectionRatsnest( const TOOL_EVENT& aEvent )
     else
     {
         // We can delete the existing map to force a recalculation
-        delete m_dynamicData;
-        m_dynamicData = nullptr;
+        m_dynamicData.reset();
     }
 
     auto selectionTool = m_toolMgr->GetTool<PCB_SELECTION_TOOL>();
@@ -1056,8 +1062,7 @@ int BOARD_INSPECTION_TOOL::UpdateSelectionRatsnest( const TOOL_EVENT& aEvent )
     if( selection.Empty() )
     {
         connectivity->ClearDynamicRatsnest();
-        delete m_dynamicData;
-        m_dynamicData = nullptr;
+        m_dynamicData.reset();
     }
     else
     {
@@ -1071,8 +1076,7 @@ int BOARD_INSPECTION_TOOL::UpdateSelectionRatsnest( const TOOL_EVENT& aEvent )
 int BOARD_INSPECTION_TOOL::HideDynamicRatsnest( const TOOL_EVENT& aEvent )
 {
     getModel<BOARD>()->GetConnectivity()->ClearDynamicRatsnest();
-    delete m_dynamicData;
-    m_dynamicData = nullptr;
+    m_dynamicData.reset();
 
     return 0;
 }
@@ -1127,17 +1131,32 @@ void BOARD_INSPECTION_TOOL::calculateSelectionRatsnest( const VECTOR2I& aDelta )
         return;
     }
 
+    VECTOR2I delta = aDelta;
+
     if( !m_dynamicData )
     {
-        m_dynamicData = new CONNECTIVITY_DATA( items, true );
+        // The copy is built at the current item positions
+        m_dynamicData = std::make_shared<CONNECTIVITY_DATA>( items, true );
         connectivity->BlockRatsnestItems( items );
+        delta = VECTOR2I( 0, 0 );
     }
-    else
-    {
-        m_dynamicData->Move( aDelta );
-    }
 
-    connectivity->ComputeDynamicRatsnest( items, m_dynamicData );
+    if( m_dynamicBoardConnectivity && m_dynamicBoardConnectivity != connectivity )
+        m_dynamicBoardConnectivity->WaitForDynamicRatsnest();
+
+    m_dynamicBoardConnectivity = connectivity;
+
+    // Mouse moves are coalesced by the worker; the canvas is refreshed whenever it has new
+    // lines, which can be after the last move event
+    connectivity->ComputeDynamicRatsnestAsync( items, m_dynamicData, delta,
+            [this]()
+            {
+                CallAfter( [this]()
+                           {
+                               m_frame->GetCanvas()->RedrawRatsnest();
+                               m_frame->GetCanvas()->Refresh();
+                           } );
+            } );
 }
 
 
@@ -57,6 +57,7 @@ class BOARD_INSPECTION_TOOL : public wxEvtHandler, public PCB_TOOL_BASE
 {
 public:
     BOARD_INSPECTION_TOOL();
+    ~BOARD_INSPECTION_TOOL();
 
     /// @copydoc TOOL_INTERACTIVE::Init()
     bool Init() override;
@@ -139,7 +140,11 @@ private:
     bool m_probingSchToPcb;     // Recursion guard when cross-probing to Eeschema
     int  m_lastNetcode;         // Used for toggling between last two highlighted nets
 
-    CONNECTIVITY_DATA* m_dynamicData;      // Cached connectivity data from the selection
+    // Cached connectivity data from the selection
+    std::shared_ptr<CONNECTIVITY_DATA> m_dynamicData;
+
+    // Board connectivity computing the dynamic ratsnest of m_dynamicData
+    std::shared_ptr<CONNECTIVITY_DATA> m_dynamicBoardConnectivity;
 
     std::unique_ptr<DIALOG_NET_INSPECTOR> m_listNetsDialog;
     DIALOG_NET_INSPECTOR::SETTINGS        m_listNetsDialogSettings;
@@ -1311,6 +1311,18 @@ TOOL_ACTION PCB_ACTIONS::routerTuneDiffPairSkew( "pcbnew.LengthTuner.TuneDiffPai
         _( "Tune skew of a differential pair" ), "",
         ps_diff_pair_tune_phase_xpm, AF_ACTIVATE, (void*) PNS::PNS_MODE_TUNE_DIFF_PAIR_SKEW );
 
+TOOL_ACTION PCB_ACTIONS::routerTuneSelectedTracks( "pcbnew.LengthTuner.TuneSelectedTracks",
+        AS_GLOBAL, 0, "",
+        _( "Tune lengths of selected tracks..." ),
+        _( "Tune the lengths of all of the selected tracks to the same target" ),
+        ps_tune_length_xpm, AF_NONE, (void*) PNS::PNS_MODE_TUNE_SINGLE );
+
+TOOL_ACTION PCB_ACTIONS::routerTuneSelectedDiffPairs( "pcbnew.LengthTuner.TuneSelectedDiffPairs",
+        AS_GLOBAL, 0, "",
+        _( "Tune lengths of selected differential pairs..." ),
+        _( "Tune the lengths of all of the selected differential pairs to the same target" ),
+        ps_diff_pair_tune_length_xpm, AF_NONE, (void*) PNS::PNS_MODE_TUNE_DIFF_PAIR );
+
 TOOL_ACTION PCB_ACTIONS::routerInlineDrag( "pcbnew.InteractiveRouter.InlineDrag",
         AS_CONTEXT );
 
@@ -194,6 +194,12 @@ public:
     /// Activation of the Push and Shove router (skew tuning mode)
     static TOOL_ACTION routerTuneDiffPairSkew;
 
+    /// Tune the lengths of the selected tracks all at once
+    static TOOL_ACTION routerTuneSelectedTracks;
+
+    /// Tune the lengths of the selected differential pairs all at once
+    static TOOL_ACTION routerTuneSelectedDiffPairs;
+
     static TOOL_ACTION routerUndoLastSegment;
 
     /// Activation of the Push and Shove settings dialogs
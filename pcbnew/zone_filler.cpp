@@ -325,75 +325,54 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
         zone->SetIsFilled( true );
     }
 
-    // Now remove insulated copper islands
-    for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : islandsList )
-    {
-        for( PCB_LAYER_ID layer : zone.m_zone->GetLayerSet().Seq() )
-        {
-            if( m_debugZoneFiller && LSET::InternalCuMask().Contains( layer ) )
-                continue;
-
-            if( !zone.m_islands.count( layer ) )
-                continue;
-
-            std::vector<int>& islands = zone.m_islands.at( layer );
+    // Now remove insulated copper islands and islands outside the board edge.  Zones are
+    // independent of each other here, so they are processed in parallel.
+    nextItem = 0;
 
-            // The list of polygons to delete must be explored from last to first in list,
-            // to allow deleting a polygon from list without breaking the remaining of the list
-            std::sort( islands.begin(), islands.end(), std::greater<int>() );
+    auto island_lambda =
+            [&]( PROGRESS_REPORTER* aReporter ) -> size_t
+            {
+                size_t num = 0;
 
-            SHAPE_POLY_SET      poly = zone.m_zone->GetFilledPolysList( layer );
-            long long int       minArea = zone.m_zone->GetMinIslandArea();
-            ISLAND_REMOVAL_MODE mode    = zone.m_zone->GetIslandRemovalMode();
+                for( size_t i = nextItem++; i < islandsList.size(); i = nextItem++ )
+                {
+                    removeIslands( islandsList[i] );
+                    num++;
 
-            for( int idx : islands )
-            {
-                SHAPE_LINE_CHAIN& outline = poly.Outline( idx );
-
-                if( mode == ISLAND_REMOVAL_MODE::ALWAYS )
-                    poly.DeletePolygon( idx );
-                else if ( mode == ISLAND_REMOVAL_MODE::AREA && outline.Area() < minArea )
-                    poly.DeletePolygon( idx );
-                else
-                    zone.m_zone->SetIsIsland( layer, idx );
-            }
+                    if( aReporter && aReporter->IsCancelled() )
+                        break;
+                }
 
-            zone.m_zone->SetFilledPolysList( layer, poly );
-            zone.m_zone->CalculateFilledArea();
+                return num;
+            };
 
-            if( m_progressReporter && m_progressReporter->IsCancelled() )
-                return false;
-        }
-    }
+    size_t islandThreadCount = std::min( cores, islandsList.size() );
+    std::vector<std::future<size_t>> islandReturns( islandThreadCount );
 
-    // Now remove islands outside the board edge
-    for( ZONE* zone : aZones )
+    if( islandThreadCount <= 1 )
+        island_lambda( m_progressReporter );
+    else
     {
-        LSET zoneCopperLayers = zone->GetLayerSet() & LSET::AllCuMask( MAX_CU_LAYERS );
+        for( size_t ii = 0; ii < islandThreadCount; ++ii )
+            islandReturns[ii] = std::async( std::launch::async, island_lambda, m_progressReporter );
 
-        for( PCB_LAYER_ID layer : zoneCopperLayers.Seq() )
+        for( size_t ii = 0; ii < islandThreadCount; ++ii )
         {
-            if( m_debugZoneFiller && LSET::InternalCuMask().Contains( layer ) )
-                continue;
-
-            SHAPE_POLY_SET poly = zone->GetFilledPolysList( layer );
-
-            for( int ii = poly.OutlineCount() - 1; ii >= 0; ii-- )
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+            do
             {
-                std::vector<SHAPE_LINE_CHAIN>& island = poly.Polygon( ii );
-
-                if( island.empty() || !m_boardOutline.Contains( island.front().CPoint( 0 ) ) )
-                    poly.DeletePolygon( ii );
-            }
-
-            zone->SetFilledPolysList( layer, poly );
-            zone->CalculateFilledArea();
+                if( m_progressReporter )
+                    m_progressReporter->KeepRefreshing();
 
-            if( m_progressReporter && m_progressReporter->IsCancelled() )
-                return false;
+                status = islandReturns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
         }
     }
 
+    if( m_progressReporter && m_progressReporter->IsCancelled() )
+        return false;
+
     if( aCheck )
     {
         bool outOfDate = false;
@@ -501,6 +480,68 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
 }
 
 
+void ZONE_FILLER::removeIslands( CN_ZONE_ISOLATED_ISLAND_LIST& aIslands )
+{
+    ZONE* zone = aIslands.m_zone;
+
+    for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+    {
+        if( m_debugZoneFiller && LSET::InternalCuMask().Contains( layer ) )
+            continue;
+
+        if( !aIslands.m_islands.count( layer ) )
+            continue;
+
+        std::vector<int>& islands = aIslands.m_islands.at( layer );
+
+        // The list of polygons to delete must be explored from last to first in list,
+        // to allow deleting a polygon from list without breaking the remaining of the list
+        std::sort( islands.begin(), islands.end(), std::greater<int>() );
+
+        SHAPE_POLY_SET      poly = zone->GetFilledPolysList( layer );
+        long long int       minArea = zone->GetMinIslandArea();
+        ISLAND_REMOVAL_MODE mode    = zone->GetIslandRemovalMode();
+
+        for( int idx : islands )
+        {
+            SHAPE_LINE_CHAIN& outline = poly.Outline( idx );
+
+            if( mode == ISLAND_REMOVAL_MODE::ALWAYS )
+                poly.DeletePolygon( idx );
+            else if ( mode == ISLAND_REMOVAL_MODE::AREA && outline.Area() < minArea )
+                poly.DeletePolygon( idx );
+            else
+                zone->SetIsIsland( layer, idx );
+        }
+
+        zone->SetFilledPolysList( layer, poly );
+    }
+
+    // Now remove islands outside the board edge
+    LSET zoneCopperLayers = zone->GetLayerSet() & LSET::AllCuMask( MAX_CU_LAYERS );
+
+    for( PCB_LAYER_ID layer : zoneCopperLayers.Seq() )
+    {
+        if( m_debugZoneFiller && LSET::InternalCuMask().Contains( layer ) )
+            continue;
+
+        SHAPE_POLY_SET poly = zone->GetFilledPolysList( layer );
+
+        for( int ii = poly.OutlineCount() - 1; ii >= 0; ii-- )
+        {
+            std::vector<SHAPE_LINE_CHAIN>& island = poly.Polygon( ii );
+
+            if( island.empty() || !m_boardOutline.Contains( island.front().CPoint( 0 ) ) )
+                poly.DeletePolygon( ii );
+        }
+
+        zone->SetFilledPolysList( layer, poly );
+    }
+
+    zone->CalculateFilledArea();
+}
+
+
 /**
  * Return true if the given pad has a thermal connection with the given zone.
  */
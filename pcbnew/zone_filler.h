@@ -34,6 +34,7 @@ class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
+struct CN_ZONE_ISOLATED_ISLAND_LIST;
 
 
 class ZONE_FILLER
@@ -109,6 +110,13 @@ private:
     bool fillSingleZone( ZONE* aZone, PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aRawPolys,
                          SHAPE_POLY_SET& aFinalPolys );
 
+    /**
+     * Remove the isolated islands listed in \a aIslands and the islands outside the board
+     * edge from the fill of a single zone.  Only that zone is modified, so different zones
+     * can be processed concurrently.
+     */
+    void removeIslands( CN_ZONE_ISOLATED_ISLAND_LIST& aIslands );
+
     /**
      * for zones having the ZONE_FILL_MODE::ZONE_FILL_MODE::HATCH_PATTERN, create a grid pattern
      * in filled areas of aZone, giving to the filled polygons a fill style like a grid
@@ -0,0 +1,156 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_thread_pool.cpp
+ * Test suite for #THREAD_POOL
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <core/thread_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Every index of a batch is run exactly once
+ */
+BOOST_AUTO_TEST_CASE( EachIndexOnce )
+{
+    THREAD_POOL pool( 3 );
+
+    std::vector<std::atomic<int>> calls( 1000 );
+
+    for( std::atomic<int>& count : calls )
+        count = 0;
+
+    pool.ParallelFor( calls.size(),
+                      [&]( size_t aIndex )
+                      {
+                          calls[aIndex]++;
+                      } );
+
+    for( const std::atomic<int>& count : calls )
+        BOOST_CHECK_EQUAL( count, 1 );
+}
+
+
+/**
+ * An empty batch does not call the function
+ */
+BOOST_AUTO_TEST_CASE( EmptyRange )
+{
+    THREAD_POOL       pool( 3 );
+    std::atomic<int>  calls( 0 );
+
+    pool.ParallelFor( 0,
+                      [&]( size_t aIndex )
+                      {
+                          calls++;
+                      } );
+
+    BOOST_CHECK_EQUAL( calls, 0 );
+}
+
+
+/**
+ * Batches started from a task run to completion on the thread of that task
+ */
+BOOST_AUTO_TEST_CASE( Nested )
+{
+    THREAD_POOL       pool( 3 );
+    std::atomic<int>  calls( 0 );
+
+    pool.ParallelFor( 8,
+                      [&]( size_t aOuter )
+                      {
+                          pool.ParallelFor( 8,
+                                            [&]( size_t aInner )
+                                            {
+                                                calls++;
+                                            } );
+                      } );
+
+    BOOST_CHECK_EQUAL( calls, 64 );
+}
+
+
+/**
+ * An exception thrown by a task is rethrown to the caller, and the pool can still be used
+ */
+BOOST_AUTO_TEST_CASE( Exception )
+{
+    THREAD_POOL       pool( 3 );
+    std::atomic<int>  calls( 0 );
+
+    BOOST_CHECK_THROW( pool.ParallelFor( 100,
+                                         [&]( size_t aIndex )
+                                         {
+                                             calls++;
+
+                                             if( aIndex == 10 )
+                                                 throw std::runtime_error( "task failed" );
+                                         } ),
+                       std::runtime_error );
+
+    calls = 0;
+
+    pool.ParallelFor( 100,
+                      [&]( size_t aIndex )
+                      {
+                          calls++;
+                      } );
+
+    BOOST_CHECK_EQUAL( calls, 100 );
+}
+
+
+/**
+ * After a shutdown batches still run, on the calling thread
+ */
+BOOST_AUTO_TEST_CASE( Shutdown )
+{
+    THREAD_POOL       pool( 3 );
+    std::atomic<int>  calls( 0 );
+
+    pool.Shutdown();
+
+    BOOST_CHECK_EQUAL( pool.GetThreadCount(), 0 );
+
+    pool.ParallelFor( 10,
+                      [&]( size_t aIndex )
+                      {
+                          calls++;
+                      } );
+
+    BOOST_CHECK_EQUAL( calls, 10 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
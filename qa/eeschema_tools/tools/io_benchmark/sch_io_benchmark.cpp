@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/io_benchmark.h>
+#include <qa_utils/utility_registry.h>
+
+#include <memory>
+#include <set>
+
+#include <wx/filename.h>
+
+#include <project.h>
+#include <sch_io_mgr.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <schematic.h>
+#include <settings/settings_manager.h>
+#include <wildcards_and_files_ext.h>
+
+
+#ifndef QA_DATA_LOCATION
+    #define QA_DATA_LOCATION "???"
+#endif
+
+#ifndef QA_EESCHEMA_DATA_LOCATION
+    #define QA_EESCHEMA_DATA_LOCATION "???"
+#endif
+
+
+/**
+ * A schematic file format.  A schematic is loaded with all of its sheets, and saving it
+ * writes every screen once.
+ */
+class SCH_BENCH_FORMAT : public KI_TEST::IO_BENCH_FORMAT
+{
+public:
+    SCH_BENCH_FORMAT( SCH_IO_MGR::SCH_FILE_T aType, SETTINGS_MANAGER& aManager ) :
+            m_type( aType ),
+            m_plugin( SCH_IO_MGR::FindPlugin( aType ) ),
+            m_manager( aManager ),
+            m_schematic( nullptr )
+    { }
+
+    std::string GetName() const override
+    {
+        return SCH_IO_MGR::ShowType( m_type ).ToStdString();
+    }
+
+    bool CanRead( const wxFileName& aFile ) const override
+    {
+        // Eagle schematics share the legacy file extension, so check the file contents.
+        return SCH_IO_MGR::GuessPluginTypeFromSchPath( aFile.GetFullPath() ) == m_type
+               && m_plugin->CheckHeader( aFile.GetFullPath() );
+    }
+
+    bool CanSave() const override
+    {
+        return true;
+    }
+
+    void Prepare( const wxString& aFile ) override
+    {
+        wxFileName pro( aFile );
+        pro.SetExt( ProjectFileExtension );
+
+        m_manager.LoadProject( pro.GetFullPath() );
+    }
+
+    void Load( const wxString& aFile, KI_TEST::IO_BENCH_COUNTS& aCounts ) override
+    {
+        m_schematic.Reset();
+        m_schematic.SetProject( &m_manager.Prj() );
+        m_schematic.SetRoot( m_plugin->Load( aFile, &m_schematic ) );
+
+        aCounts = KI_TEST::IO_BENCH_COUNTS();
+
+        SCH_SCREENS screens( m_schematic.Root() );
+
+        for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+        {
+            aCounts.m_Bytes += wxFileName::GetSize( screen->GetFileName() ).GetValue();
+            aCounts.m_Items += screen->Items().size();
+        }
+    }
+
+    void Save( const wxString& aFile, KI_TEST::IO_BENCH_COUNTS& aCounts ) override
+    {
+        std::set<SCH_SCREEN*> saved;
+
+        aCounts = KI_TEST::IO_BENCH_COUNTS();
+
+        for( const SCH_SHEET_PATH& path : m_schematic.GetSheets() )
+        {
+            SCH_SCREEN* screen = path.LastScreen();
+
+            if( !saved.insert( screen ).second )
+                continue;
+
+            m_plugin->Save( aFile, path.Last(), &m_schematic );
+
+            aCounts.m_Bytes += wxFileName::GetSize( aFile ).GetValue();
+            aCounts.m_Items += screen->Items().size();
+        }
+    }
+
+    void Unload() override
+    {
+        m_schematic.Reset();
+    }
+
+private:
+    SCH_IO_MGR::SCH_FILE_T          m_type;
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER m_plugin;
+    SETTINGS_MANAGER&               m_manager;
+    SCHEMATIC                       m_schematic;
+};
+
+
+int sch_io_benchmark_func( int argc, char** argv )
+{
+    SETTINGS_MANAGER manager( true );
+
+    std::vector<std::unique_ptr<KI_TEST::IO_BENCH_FORMAT>> formats;
+
+    formats.push_back( std::make_unique<SCH_BENCH_FORMAT>( SCH_IO_MGR::SCH_KICAD, manager ) );
+    formats.push_back( std::make_unique<SCH_BENCH_FORMAT>( SCH_IO_MGR::SCH_LEGACY, manager ) );
+
+    return KI_TEST::RunIoBenchmark( argc, argv, formats,
+                                    { QA_DATA_LOCATION, QA_EESCHEMA_DATA_LOCATION } );
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "sch_io_benchmark",
+        "Benchmark loading and saving of schematic files",
+        sch_io_benchmark_func,
+} );
@@ -74,5 +74,38 @@ BOOST_AUTO_TEST_CASE( PointInside )
 }
 
 
+BOOST_AUTO_TEST_CASE( AdaptiveGrid )
+{
+    // A gear-like outline with many vertices, as found in large zone fills
+    SHAPE_LINE_CHAIN outline;
+    const int        vertexCount = 6000;
+
+    for( int i = 0; i < vertexCount; i++ )
+    {
+        double angle = 2.0 * M_PI * i / vertexCount;
+        double radius = ( i % 2 ) ? 10000000.0 : 9000000.0;
+
+        outline.Append( KiROUND( radius * cos( angle ) ), KiROUND( radius * sin( angle ) ) );
+    }
+
+    outline.SetClosed( true );
+
+    int gridSize = POLY_GRID_PARTITION::AdaptiveGridSize( outline );
+
+    BOOST_CHECK_GT( gridSize, 16 );
+
+    POLY_GRID_PARTITION part( outline, gridSize );
+
+    for( int x = -10500001; x < 10500000; x += 123457 )
+    {
+        for( int y = -10500001; y < 10500000; y += 98765 )
+        {
+            VECTOR2I p( x, y );
+
+            BOOST_CHECK_EQUAL( outline.PointInside( p ), part.ContainsPoint( p ) != 0 );
+        }
+    }
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
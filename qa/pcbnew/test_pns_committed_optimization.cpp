@@ -0,0 +1,176 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <board.h>
+#include <convert_to_biu.h>
+#include <netinfo.h>
+#include <track.h>
+
+#include <router/pns_debug_decorator.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/pns_segment.h>
+#include <router/pns_sizes_settings.h>
+
+
+/**
+ * Commits the routed segments straight to the board, and records the board items it
+ * changes, as the router tool does through its BOARD_COMMIT and board listener.
+ */
+class TEST_COMMIT_IFACE : public PNS_KICAD_IFACE_BASE
+{
+public:
+    void AddItem( PNS::ITEM* aItem ) override
+    {
+        if( aItem->Kind() != PNS::ITEM::SEGMENT_T )
+            return;
+
+        PNS::SEGMENT* seg = static_cast<PNS::SEGMENT*>( aItem );
+        TRACK*        track = new TRACK( m_board );
+
+        track->SetStart( wxPoint( seg->Seg().A.x, seg->Seg().A.y ) );
+        track->SetEnd( wxPoint( seg->Seg().B.x, seg->Seg().B.y ) );
+        track->SetWidth( seg->Width() );
+        track->SetLayer( ToLAYER_ID( seg->Layers().Start() ) );
+        track->SetNetCode( std::max( 0, seg->Net() ) );
+
+        m_board->Add( track );
+        aItem->SetParent( track );
+        m_changedItems.insert( track );
+    }
+
+    void RemoveItem( PNS::ITEM* aItem ) override
+    {
+        BOARD_ITEM* parent = aItem->Parent();
+
+        if( !parent || parent->Type() != PCB_TRACE_T )
+            return;
+
+        // Kept alive as in the undo buffer: the world still refers to it until it is updated
+        m_board->Remove( parent );
+        m_removedItems.emplace_back( parent );
+        m_changedItems.erase( parent );
+        m_removedParents.insert( parent );
+    }
+
+    std::unordered_set<BOARD_ITEM*>          m_changedItems;
+    std::unordered_set<const BOARD_ITEM*>    m_removedParents;
+    std::vector<std::unique_ptr<BOARD_ITEM>> m_removedItems;
+};
+
+
+static double totalTrackLength( BOARD& aBoard, int aNet )
+{
+    double length = 0.0;
+
+    for( TRACK* track : aBoard.Tracks() )
+    {
+        if( track->GetNetCode() == aNet )
+            length += track->GetLength();
+    }
+
+    return length;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PnsCommittedOptimization )
+
+
+/**
+ * The optimization of a committed route runs after the editor has handled the commit, and so
+ * after the router world has been updated from the board.  It must still find the route, and
+ * straighten it once the obstacle it went around is gone.
+ */
+BOOST_AUTO_TEST_CASE( OptimizeAfterWorldUpdate )
+{
+    BOARD board;
+
+    board.Add( new NETINFO_ITEM( &board, "Obstacle", 1 ) );
+
+    TRACK* obstacle = new TRACK( &board );
+    obstacle->SetStart( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( -1 ) ) );
+    obstacle->SetEnd( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 1 ) ) );
+    obstacle->SetWidth( Millimeter2iu( 0.25 ) );
+    obstacle->SetLayer( F_Cu );
+    obstacle->SetNetCode( 1 );
+    board.Add( obstacle );
+
+    TEST_COMMIT_IFACE iface;
+
+    iface.SetBoard( &board );
+    iface.SetDebugDecorator( new PNS::DEBUG_DECORATOR );
+
+    PNS::ROUTING_SETTINGS settings( nullptr, "" );
+    settings.SetMode( PNS::RM_Walkaround );
+
+    PNS::ROUTER router;
+    router.SetInterface( &iface );
+    router.ClearWorld();
+    router.SyncWorld();
+    router.LoadSettings( &settings );
+    router.SetMode( PNS::PNS_MODE_ROUTE_SINGLE );
+
+    PNS::SIZES_SETTINGS sizes( router.Sizes() );
+    sizes.SetTrackWidth( Millimeter2iu( 0.25 ) );
+    router.UpdateSizes( sizes );
+
+    // Route across the obstacle, which the track has to go around
+    VECTOR2I start( 0, 0 );
+    VECTOR2I end( Millimeter2iu( 20 ), 0 );
+
+    BOOST_REQUIRE( router.StartRouting( start, nullptr, F_Cu ) );
+    router.Move( end, nullptr );
+    router.FixRoute( end, nullptr, true );
+    router.CommitRouting();
+
+    double routedLength = totalTrackLength( board, 0 );
+
+    BOOST_REQUIRE_GT( routedLength, end.x );
+
+    // Then the obstacle goes away, and the editor updates the world with the committed
+    // tracks before the deferred optimization gets to run
+    board.Remove( obstacle );
+    iface.m_removedItems.emplace_back( obstacle );
+    iface.m_removedParents.insert( obstacle );
+
+    router.UpdateWorld( iface.m_changedItems, iface.m_removedParents );
+    iface.m_changedItems.clear();
+    iface.m_removedParents.clear();
+
+    BOOST_CHECK( router.OptimizeCommittedLines( 1000 ) );
+    BOOST_CHECK_LT( totalTrackLength( board, 0 ), routedLength );
+
+    // The committed tracks are only optimized once
+    BOOST_CHECK( !router.OptimizeCommittedLines( 1000 ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
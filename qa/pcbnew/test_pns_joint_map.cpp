@@ -0,0 +1,336 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pns_joint_map.cpp
+ * Test suite for #PNS::JOINT_MAP
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <router/pns_joint_map.h>
+
+using PNS::JOINT;
+using PNS::JOINT_MAP;
+
+
+static JOINT::HASH_TAG makeTag( int aX, int aNet = 1 )
+{
+    JOINT::HASH_TAG tag;
+
+    tag.pos = VECTOR2I( aX, 0 );
+    tag.net = aNet;
+
+    return tag;
+}
+
+
+static JOINT& insertJoint( JOINT_MAP& aMap, const JOINT::HASH_TAG& aTag, int aLayer = 0 )
+{
+    return aMap.Insert( std::make_unique<JOINT>( aTag.pos, LAYER_RANGE( aLayer ), aTag.net ) );
+}
+
+
+/**
+ * @return \a aCount distinct tags whose home slot is \a aHome in a table of \a aCapacity slots.
+ */
+static std::vector<JOINT::HASH_TAG> tagsWithHome( size_t aHome, size_t aCount,
+                                                  size_t aCapacity = 16 )
+{
+    std::vector<JOINT::HASH_TAG> tags;
+
+    for( int x = 0; tags.size() < aCount; x++ )
+    {
+        JOINT::HASH_TAG tag = makeTag( x );
+
+        if( ( JOINT_MAP::HashTag( tag ) & ( aCapacity - 1 ) ) == aHome )
+            tags.push_back( tag );
+    }
+
+    return tags;
+}
+
+
+static bool contains( const JOINT_MAP& aMap, const JOINT::HASH_TAG& aTag, int aLayer = 0 )
+{
+    JOINT* joint = aMap.Find( aTag, aLayer );
+
+    return joint && joint->Tag() == aTag && joint->Layers().Overlaps( aLayer );
+}
+
+
+BOOST_AUTO_TEST_SUITE( PnsJointMap )
+
+
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    JOINT_MAP map;
+
+    BOOST_CHECK_EQUAL( map.size(), 0 );
+    BOOST_CHECK( map.begin() == map.end() );
+    BOOST_CHECK( !map.Find( makeTag( 0 ), 0 ) );
+    BOOST_CHECK( !map.Contains( makeTag( 0 ) ) );
+    BOOST_CHECK( !map.Take( makeTag( 0 ), LAYER_RANGE( 0 ) ) );
+}
+
+
+/**
+ * Joints sharing a tag on disjoint layers are found and removed by layer
+ */
+BOOST_AUTO_TEST_CASE( SameTagOtherLayers )
+{
+    JOINT_MAP       map;
+    JOINT::HASH_TAG tag = makeTag( 100 );
+
+    JOINT* top = &insertJoint( map, tag, 0 );
+    JOINT* bottom = &insertJoint( map, tag, 31 );
+
+    BOOST_CHECK_EQUAL( map.Find( tag, 0 ), top );
+    BOOST_CHECK_EQUAL( map.Find( tag, 31 ), bottom );
+    BOOST_CHECK( !map.Find( tag, 1 ) );
+    BOOST_CHECK( !map.Find( makeTag( 100, 2 ), 0 ) );
+
+    int count = 0;
+    map.ForEach( tag, [&]( JOINT& ) { count++; } );
+    BOOST_CHECK_EQUAL( count, 2 );
+
+    std::unique_ptr<JOINT> taken = map.Take( tag, LAYER_RANGE( 31 ) );
+
+    BOOST_CHECK_EQUAL( taken.get(), bottom );
+    BOOST_CHECK_EQUAL( map.Find( tag, 0 ), top );
+    BOOST_CHECK( map.Contains( tag ) );
+    BOOST_CHECK_EQUAL( map.size(), 1 );
+}
+
+
+/**
+ * Removing a joint from the middle of a probe sequence shifts the rest of the sequence back,
+ * and leaves the joints which are already at their home slot in place
+ */
+BOOST_AUTO_TEST_CASE( BackwardShift )
+{
+    JOINT_MAP map;
+
+    // Three joints with home 3 take slots 3, 4 and 5, pushing the one with home 4 to slot 6
+    // and the one with home 6 to slot 7
+    std::vector<JOINT::HASH_TAG> chain = tagsWithHome( 3, 3 );
+    JOINT::HASH_TAG              next = tagsWithHome( 4, 1 )[0];
+    JOINT::HASH_TAG              after = tagsWithHome( 6, 1 )[0];
+
+    for( const JOINT::HASH_TAG& tag : chain )
+        insertJoint( map, tag );
+
+    insertJoint( map, next );
+    insertJoint( map, after );
+
+    BOOST_REQUIRE_EQUAL( map.Capacity(), 16 );
+
+    BOOST_CHECK( map.Take( chain[1], LAYER_RANGE( 0 ) ) );
+    BOOST_CHECK( !contains( map, chain[1] ) );
+    BOOST_CHECK( contains( map, chain[0] ) );
+    BOOST_CHECK( contains( map, chain[2] ) );
+    BOOST_CHECK( contains( map, next ) );
+    BOOST_CHECK( contains( map, after ) );
+
+    BOOST_CHECK( map.Take( chain[0], LAYER_RANGE( 0 ) ) );
+    BOOST_CHECK( contains( map, chain[2] ) );
+    BOOST_CHECK( contains( map, next ) );
+    BOOST_CHECK( contains( map, after ) );
+
+    BOOST_CHECK( map.Take( chain[2], LAYER_RANGE( 0 ) ) );
+    BOOST_CHECK( contains( map, next ) );
+    BOOST_CHECK( contains( map, after ) );
+    BOOST_CHECK_EQUAL( map.size(), 2 );
+
+    // A removed tag is not found again, even if it is taken twice
+    BOOST_CHECK( !map.Take( chain[2], LAYER_RANGE( 0 ) ) );
+    BOOST_CHECK_EQUAL( map.size(), 2 );
+}
+
+
+/**
+ * Probe sequences starting in the last slot wrap around to the first ones, and are still
+ * shifted back correctly across the end of the table
+ */
+BOOST_AUTO_TEST_CASE( WrapAround )
+{
+    JOINT_MAP map;
+
+    // Slots 15, 0 and 1 for the joints with home 15, then slot 2 for the one with home 0
+    std::vector<JOINT::HASH_TAG> last = tagsWithHome( 15, 3 );
+    JOINT::HASH_TAG              first = tagsWithHome( 0, 1 )[0];
+
+    for( const JOINT::HASH_TAG& tag : last )
+        insertJoint( map, tag );
+
+    insertJoint( map, first );
+
+    BOOST_REQUIRE_EQUAL( map.Capacity(), 16 );
+
+    for( const JOINT::HASH_TAG& tag : last )
+        BOOST_CHECK( contains( map, tag ) );
+
+    BOOST_CHECK( contains( map, first ) );
+
+    BOOST_CHECK( map.Take( last[0], LAYER_RANGE( 0 ) ) );
+    BOOST_CHECK( contains( map, last[1] ) );
+    BOOST_CHECK( contains( map, last[2] ) );
+    BOOST_CHECK( contains( map, first ) );
+
+    BOOST_CHECK( map.Take( last[2], LAYER_RANGE( 0 ) ) );
+    BOOST_CHECK( contains( map, last[1] ) );
+    BOOST_CHECK( contains( map, first ) );
+
+    int count = 0;
+
+    for( JOINT& joint : map )
+    {
+        (void) joint;
+        count++;
+    }
+
+    BOOST_CHECK_EQUAL( count, 2 );
+}
+
+
+/**
+ * The table grows as joints are added, keeps every joint, and keeps the pointers to them
+ */
+BOOST_AUTO_TEST_CASE( Rehash )
+{
+    JOINT_MAP           map;
+    std::vector<JOINT*> joints;
+
+    for( int i = 0; i < 1000; i++ )
+        joints.push_back( &insertJoint( map, makeTag( i * 1000 ) ) );
+
+    BOOST_CHECK_EQUAL( map.size(), 1000 );
+    BOOST_CHECK_GE( map.Capacity(), 2 * map.size() );
+    BOOST_CHECK_EQUAL( map.Capacity() & ( map.Capacity() - 1 ), 0 );
+
+    for( int i = 0; i < 1000; i++ )
+        BOOST_CHECK_EQUAL( map.Find( makeTag( i * 1000 ), 0 ), joints[i] );
+
+    size_t count = 0;
+
+    for( JOINT& joint : map )
+    {
+        (void) joint;
+        count++;
+    }
+
+    BOOST_CHECK_EQUAL( count, map.size() );
+}
+
+
+/**
+ * A copy owns its own joints
+ */
+BOOST_AUTO_TEST_CASE( Copy )
+{
+    JOINT_MAP map;
+
+    for( int i = 0; i < 20; i++ )
+        insertJoint( map, makeTag( i ) );
+
+    JOINT_MAP copy( map );
+
+    BOOST_CHECK_EQUAL( copy.size(), map.size() );
+    BOOST_CHECK_NE( copy.Find( makeTag( 5 ), 0 ), map.Find( makeTag( 5 ), 0 ) );
+
+    copy.Take( makeTag( 5 ), LAYER_RANGE( 0 ) );
+    insertJoint( copy, makeTag( 50 ) );
+
+    BOOST_CHECK( contains( map, makeTag( 5 ) ) );
+    BOOST_CHECK( !contains( map, makeTag( 50 ) ) );
+    BOOST_CHECK( !contains( copy, makeTag( 5 ) ) );
+    BOOST_CHECK( contains( copy, makeTag( 50 ) ) );
+}
+
+
+/**
+ * Random inserts and removals over a few tags, which collide often, agree with a plain list
+ */
+BOOST_AUTO_TEST_CASE( RandomOperations )
+{
+    struct ENTRY
+    {
+        JOINT::HASH_TAG tag;
+        int             layer;
+    };
+
+    JOINT_MAP          map;
+    std::vector<ENTRY> reference;
+    std::mt19937       rng( 42 );
+
+    auto findReference =
+            [&]( const JOINT::HASH_TAG& aTag, int aLayer )
+            {
+                for( size_t i = 0; i < reference.size(); i++ )
+                {
+                    if( reference[i].tag == aTag && reference[i].layer == aLayer )
+                        return (int) i;
+                }
+
+                return -1;
+            };
+
+    for( int step = 0; step < 20000; step++ )
+    {
+        JOINT::HASH_TAG tag = makeTag( rng() % 64, rng() % 2 );
+        int             layer = rng() % 2;
+        int             index = findReference( tag, layer );
+
+        if( index < 0 )
+        {
+            insertJoint( map, tag, layer );
+            reference.push_back( { tag, layer } );
+        }
+        else
+        {
+            BOOST_REQUIRE( map.Take( tag, LAYER_RANGE( layer ) ) );
+            reference.erase( reference.begin() + index );
+        }
+
+        BOOST_REQUIRE_EQUAL( map.size(), reference.size() );
+    }
+
+    for( int x = 0; x < 64; x++ )
+    {
+        for( int net = 0; net < 2; net++ )
+        {
+            for( int layer = 0; layer < 2; layer++ )
+            {
+                bool expected = findReference( makeTag( x, net ), layer ) >= 0;
+                BOOST_CHECK_EQUAL( contains( map, makeTag( x, net ), layer ), expected );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,694 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/io_benchmark.h>
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include <nlohmann/json.hpp>
+
+#include <wx/cmdline.h>
+
+#include <board.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+#include <convert_to_biu.h>
+#include <footprint.h>
+#include <netinfo.h>
+#include <pad.h>
+#include <profile.h>
+#include <track.h>
+
+
+/**
+ * Parameters of a synthetic board.
+ *
+ * Each net is a row of through hole pads, connected from left to right by tracks on one of
+ * the copper layers.  Every other connection changes layer through a via.  The pads of
+ * eight neighbouring rows in a column share a footprint, so moving a footprint drags the
+ * ratsnest of several nets.
+ */
+struct SYNTH_BOARD_PARAMS
+{
+    long m_Nets = 1000;             ///< Number of ordinary nets.
+    long m_PadsPerNet = 4;          ///< Pads in each ordinary net.
+    long m_Layers = 4;              ///< Copper layer count.
+    long m_GiantNetPads = 0;        ///< Pads of one extra huge net (e.g. a ground net).
+    long m_UnroutedPercent = 20;    ///< Share of the pad to pad connections left unrouted.
+};
+
+
+/**
+ * One edit replayed against the board.  Indices refer to BOARD::Tracks() and
+ * BOARD::Footprints() at the time the edit is applied.
+ */
+struct BENCH_EDIT
+{
+    enum TYPE
+    {
+        MOVE_TRACK,
+        MOVE_FOOTPRINT,
+        DELETE_TRACK
+    };
+
+    TYPE    m_Type;
+    size_t  m_Index;
+    wxPoint m_Delta;
+};
+
+
+/**
+ * Timings and allocations of one pipeline stage over all of its runs.
+ */
+struct CONN_BENCH_STAGE
+{
+    std::vector<double>  m_timesMs;
+    KI_TEST::ALLOC_STATS m_allocs = { 0, 0 };
+
+    nlohmann::json ToJson() const
+    {
+        if( m_timesMs.empty() )
+            return nlohmann::json();
+
+        std::vector<double> sorted = m_timesMs;
+        std::sort( sorted.begin(), sorted.end() );
+
+        double total = 0.0;
+
+        for( double t : sorted )
+            total += t;
+
+        nlohmann::json stage;
+
+        stage["runs"]            = sorted.size();
+        stage["min_ms"]          = sorted.front();
+        stage["median_ms"]       = sorted[ sorted.size() / 2 ];
+        stage["max_ms"]          = sorted.back();
+        stage["total_ms"]        = total;
+        stage["allocations"]     = m_allocs.m_Count / (double) sorted.size();
+        stage["allocated_bytes"] = m_allocs.m_Bytes / (double) sorted.size();
+
+        return stage;
+    }
+};
+
+
+/**
+ * Time \a aFunc, adding its duration and allocations to \a aStage.
+ */
+template <typename FUNC>
+static void measure( CONN_BENCH_STAGE& aStage, FUNC aFunc )
+{
+    KI_TEST::ALLOC_STATS before = KI_TEST::GetAllocStats();
+    PROF_COUNTER         timer;
+
+    aFunc();
+
+    timer.Stop();
+
+    KI_TEST::ALLOC_STATS after = KI_TEST::GetAllocStats();
+
+    aStage.m_timesMs.push_back( timer.msecs() );
+    aStage.m_allocs.m_Count += after.m_Count - before.m_Count;
+    aStage.m_allocs.m_Bytes += after.m_Bytes - before.m_Bytes;
+}
+
+
+static PCB_LAYER_ID copperLayer( int aIndex, int aLayerCount )
+{
+    if( aIndex == 0 )
+        return F_Cu;
+    else if( aIndex == aLayerCount - 1 )
+        return B_Cu;
+    else
+        return ToLAYER_ID( In1_Cu + aIndex - 1 );
+}
+
+
+static const int g_pitch = Millimeter2iu( 2.54 );
+
+
+static PAD* addPad( FOOTPRINT* aFootprint, NETINFO_ITEM* aNet, const wxPoint& aPos )
+{
+    PAD* pad = new PAD( aFootprint );
+
+    aFootprint->Add( pad, ADD_MODE::APPEND );
+
+    pad->SetShape( PAD_SHAPE_CIRCLE );
+    pad->SetAttribute( PAD_ATTRIB_PTH );
+    pad->SetLayerSet( PAD::PTHMask() );
+    pad->SetSize( wxSize( Millimeter2iu( 1.5 ), Millimeter2iu( 1.5 ) ) );
+    pad->SetDrillSize( wxSize( Millimeter2iu( 0.8 ), Millimeter2iu( 0.8 ) ) );
+    pad->SetPosition( aPos );
+    pad->SetPos0( aPos - aFootprint->GetPosition() );
+    pad->SetName( wxString::Format( "%d", (int) aFootprint->Pads().size() ) );
+    pad->SetNet( aNet );
+
+    return pad;
+}
+
+
+static void addTrack( BOARD& aBoard, NETINFO_ITEM* aNet, const wxPoint& aStart,
+                      const wxPoint& aEnd, PCB_LAYER_ID aLayer )
+{
+    TRACK* track = new TRACK( &aBoard );
+
+    track->SetStart( aStart );
+    track->SetEnd( aEnd );
+    track->SetWidth( Millimeter2iu( 0.25 ) );
+    track->SetLayer( aLayer );
+    track->SetNet( aNet );
+
+    aBoard.Add( track, ADD_MODE::APPEND );
+}
+
+
+/**
+ * Connect \a aStart to \a aEnd, through a via at the middle if \a aLayerB differs from
+ * \a aLayerA.
+ */
+static void addRoute( BOARD& aBoard, NETINFO_ITEM* aNet, const wxPoint& aStart,
+                      const wxPoint& aEnd, PCB_LAYER_ID aLayerA, PCB_LAYER_ID aLayerB )
+{
+    if( aLayerA == aLayerB )
+    {
+        addTrack( aBoard, aNet, aStart, aEnd, aLayerA );
+        return;
+    }
+
+    wxPoint mid( ( aStart.x + aEnd.x ) / 2, ( aStart.y + aEnd.y ) / 2 );
+    VIA*    via = new VIA( &aBoard );
+
+    via->SetViaType( VIATYPE::THROUGH );
+    via->SetLayerPair( F_Cu, B_Cu );
+    via->SetPosition( mid );
+    via->SetWidth( Millimeter2iu( 0.6 ) );
+    via->SetDrill( Millimeter2iu( 0.3 ) );
+    via->SetNet( aNet );
+
+    aBoard.Add( via, ADD_MODE::APPEND );
+
+    addTrack( aBoard, aNet, aStart, mid, aLayerA );
+    addTrack( aBoard, aNet, mid, aEnd, aLayerB );
+}
+
+
+static std::unique_ptr<BOARD> buildSyntheticBoard( const SYNTH_BOARD_PARAMS& aParams,
+                                                   std::mt19937& aRng )
+{
+    std::unique_ptr<BOARD>     board = std::make_unique<BOARD>();
+    std::vector<NETINFO_ITEM*> nets;
+    int                        layers = aParams.m_Layers;
+    const int                  rowsPerFootprint = 8;
+
+    board->SetCopperLayerCount( layers );
+
+    auto isRouted =
+            [&]()
+            {
+                return (long) ( aRng() % 100 ) >= aParams.m_UnroutedPercent;
+            };
+
+    for( long n = 0; n < aParams.m_Nets; n++ )
+    {
+        wxString name = wxString::Format( "N%ld", n + 1 );
+
+        nets.push_back( new NETINFO_ITEM( board.get(), name, n + 1 ) );
+        board->Add( nets.back() );
+    }
+
+    // Ordinary nets: one row of pads per net
+    for( long row0 = 0; row0 < aParams.m_Nets; row0 += rowsPerFootprint )
+    {
+        for( long col = 0; col < aParams.m_PadsPerNet; col++ )
+        {
+            FOOTPRINT* fp = new FOOTPRINT( board.get() );
+
+            fp->SetReference( wxString::Format( "U%ld_%ld", row0 / rowsPerFootprint + 1,
+                                                col + 1 ) );
+            fp->SetPosition( wxPoint( col * g_pitch, row0 * g_pitch ) );
+
+            for( long row = row0; row < std::min( row0 + rowsPerFootprint, aParams.m_Nets ); row++ )
+                addPad( fp, nets[row], wxPoint( col * g_pitch, row * g_pitch ) );
+
+            board->Add( fp, ADD_MODE::APPEND );
+        }
+    }
+
+    for( long row = 0; row < aParams.m_Nets; row++ )
+    {
+        PCB_LAYER_ID layerA = copperLayer( row % layers, layers );
+
+        for( long col = 0; col + 1 < aParams.m_PadsPerNet; col++ )
+        {
+            if( !isRouted() )
+                continue;
+
+            PCB_LAYER_ID layerB = ( col % 2 ) ? copperLayer( ( row + 1 ) % layers, layers )
+                                              : layerA;
+
+            addRoute( *board, nets[row], wxPoint( col * g_pitch, row * g_pitch ),
+                      wxPoint( ( col + 1 ) * g_pitch, row * g_pitch ), layerA, layerB );
+        }
+    }
+
+    // The huge net: a square grid of pads below the ordinary nets, one footprint per row,
+    // connected along the rows and down the first column
+    if( aParams.m_GiantNetPads > 0 )
+    {
+        NETINFO_ITEM* giant = new NETINFO_ITEM( board.get(), "GND", aParams.m_Nets + 1 );
+        board->Add( giant );
+
+        long side = std::max( 1L, (long) std::ceil( std::sqrt( aParams.m_GiantNetPads ) ) );
+        long y0 = aParams.m_Nets + 2;
+        long placed = 0;
+
+        for( long row = 0; placed < aParams.m_GiantNetPads; row++ )
+        {
+            FOOTPRINT* fp = new FOOTPRINT( board.get() );
+            long       y = ( y0 + row ) * g_pitch;
+            long       cols = std::min( side, aParams.m_GiantNetPads - placed );
+
+            fp->SetReference( wxString::Format( "J%ld", row + 1 ) );
+            fp->SetPosition( wxPoint( 0, y ) );
+
+            for( long col = 0; col < cols; col++ )
+                addPad( fp, giant, wxPoint( col * g_pitch, y ) );
+
+            board->Add( fp, ADD_MODE::APPEND );
+
+            for( long col = 0; col + 1 < cols; col++ )
+            {
+                if( isRouted() )
+                    addTrack( *board, giant, wxPoint( col * g_pitch, y ),
+                              wxPoint( ( col + 1 ) * g_pitch, y ), F_Cu );
+            }
+
+            if( row > 0 && isRouted() )
+                addTrack( *board, giant, wxPoint( 0, y - g_pitch ), wxPoint( 0, y ), B_Cu );
+
+            placed += cols;
+        }
+    }
+
+    return board;
+}
+
+
+static bool readEdits( const std::string& aFile, std::vector<BENCH_EDIT>& aEdits )
+{
+    std::ifstream in( aFile );
+    std::string   line;
+
+    if( !in )
+        return false;
+
+    while( std::getline( in, line ) )
+    {
+        if( line.empty() || line[0] == '#' )
+            continue;
+
+        std::istringstream ss( line );
+        std::string        type;
+        BENCH_EDIT         edit = { BENCH_EDIT::MOVE_TRACK, 0, wxPoint( 0, 0 ) };
+
+        ss >> type >> edit.m_Index;
+
+        if( type == "move_track" )
+            edit.m_Type = BENCH_EDIT::MOVE_TRACK;
+        else if( type == "move_footprint" )
+            edit.m_Type = BENCH_EDIT::MOVE_FOOTPRINT;
+        else if( type == "delete_track" )
+            edit.m_Type = BENCH_EDIT::DELETE_TRACK;
+        else
+            return false;
+
+        if( edit.m_Type != BENCH_EDIT::DELETE_TRACK )
+            ss >> edit.m_Delta.x >> edit.m_Delta.y;
+
+        if( ss.fail() )
+            return false;
+
+        aEdits.push_back( edit );
+    }
+
+    return true;
+}
+
+
+static void writeEdit( std::ostream& aOut, const BENCH_EDIT& aEdit )
+{
+    switch( aEdit.m_Type )
+    {
+    case BENCH_EDIT::MOVE_TRACK:     aOut << "move_track ";     break;
+    case BENCH_EDIT::MOVE_FOOTPRINT: aOut << "move_footprint "; break;
+    case BENCH_EDIT::DELETE_TRACK:   aOut << "delete_track ";   break;
+    }
+
+    aOut << aEdit.m_Index;
+
+    if( aEdit.m_Type != BENCH_EDIT::DELETE_TRACK )
+        aOut << " " << aEdit.m_Delta.x << " " << aEdit.m_Delta.y;
+
+    aOut << std::endl;
+}
+
+
+static BENCH_EDIT randomEdit( const BOARD& aBoard, std::mt19937& aRng )
+{
+    BENCH_EDIT edit;
+    int        kind = aRng() % 10;
+
+    edit.m_Delta = wxPoint( (int) ( aRng() % g_pitch ) - g_pitch / 2,
+                            (int) ( aRng() % g_pitch ) - g_pitch / 2 );
+
+    if( kind < 2 && !aBoard.Footprints().empty() )
+    {
+        edit.m_Type = BENCH_EDIT::MOVE_FOOTPRINT;
+        edit.m_Index = aRng() % aBoard.Footprints().size();
+    }
+    else if( kind < 4 && !aBoard.Tracks().empty() )
+    {
+        edit.m_Type = BENCH_EDIT::DELETE_TRACK;
+        edit.m_Index = aRng() % aBoard.Tracks().size();
+    }
+    else
+    {
+        edit.m_Type = BENCH_EDIT::MOVE_TRACK;
+        edit.m_Index = aBoard.Tracks().empty() ? 0 : aRng() % aBoard.Tracks().size();
+    }
+
+    return edit;
+}
+
+
+/**
+ * Apply \a aEdit to \a aBoard and update its connectivity, without recalculating the
+ * ratsnest.
+ *
+ * @return false if the edit refers to an item which does not exist.
+ */
+static bool applyEdit( BOARD& aBoard, const BENCH_EDIT& aEdit )
+{
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = aBoard.GetConnectivity();
+
+    switch( aEdit.m_Type )
+    {
+    case BENCH_EDIT::MOVE_FOOTPRINT:
+    {
+        if( aEdit.m_Index >= aBoard.Footprints().size() )
+            return false;
+
+        FOOTPRINT* fp = aBoard.Footprints()[aEdit.m_Index];
+
+        fp->Move( aEdit.m_Delta );
+        connectivity->Update( fp );
+        return true;
+    }
+
+    case BENCH_EDIT::MOVE_TRACK:
+    {
+        if( aEdit.m_Index >= aBoard.Tracks().size() )
+            return false;
+
+        TRACK* track = aBoard.Tracks()[aEdit.m_Index];
+
+        track->Move( aEdit.m_Delta );
+        connectivity->Update( track );
+        return true;
+    }
+
+    case BENCH_EDIT::DELETE_TRACK:
+    {
+        if( aEdit.m_Index >= aBoard.Tracks().size() )
+            return false;
+
+        TRACK* track = aBoard.Tracks()[aEdit.m_Index];
+
+        // BOARD::Remove() also removes the track from the connectivity
+        aBoard.Remove( track );
+        delete track;
+        return true;
+    }
+    }
+
+    return false;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters",
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "n", "nets", "number of nets of the synthetic board (default 1000)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "p", "pads", "pads per net (default 4)", wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "l", "layers", "copper layer count (default 4)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "g", "giant", "pads of an extra huge net (default 0)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "u", "unrouted", "percentage of unrouted connections (default 20)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "s", "seed", "random seed (default 1)", wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "r", "reps", "repetitions of the full pipeline stages (default 3)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "d", "dynamic", "dynamic ratsnest steps (default 50)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "e", "edits", "number of random edits (default 100)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "w", "record", "write the edit sequence to this file",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "x", "replay", "replay the edit sequence from this file",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "o", "output", "write the JSON report to this file instead of stdout",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, "board file to use instead of a synthetic board",
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum CONN_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    REPLAY_FAILED,
+};
+
+
+int connectivity_benchmark_main( int argc, char** argv )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( "Run the connectivity pipeline (build, net propagation, ratsnest, "
+                            "dynamic ratsnest and incremental edits) on a synthetic or given "
+                            "board and report timings, allocations and peak memory as JSON." );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    SYNTH_BOARD_PARAMS params;
+    long               seed = 1;
+    long               reps = 3;
+    long               dynamicSteps = 50;
+    long               editCount = 100;
+
+    cl_parser.Found( "nets", &params.m_Nets );
+    cl_parser.Found( "pads", &params.m_PadsPerNet );
+    cl_parser.Found( "layers", &params.m_Layers );
+    cl_parser.Found( "giant", &params.m_GiantNetPads );
+    cl_parser.Found( "unrouted", &params.m_UnroutedPercent );
+    cl_parser.Found( "seed", &seed );
+    cl_parser.Found( "reps", &reps );
+    cl_parser.Found( "dynamic", &dynamicSteps );
+    cl_parser.Found( "edits", &editCount );
+
+    if( params.m_Nets < 0 || params.m_PadsPerNet < 1 || params.m_Layers < 2
+            || params.m_Layers > MAX_CU_LAYERS || params.m_GiantNetPads < 0 || reps < 1
+            || dynamicSteps < 0 || editCount < 0 )
+    {
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::mt19937           rng( seed );
+    std::unique_ptr<BOARD> board;
+    nlohmann::json         report;
+
+    if( cl_parser.GetParamCount() > 0 )
+    {
+        board = KI_TEST::ReadBoardFromFileOrStream( cl_parser.GetParam( 0 ).ToStdString() );
+
+        if( !board )
+            return CONN_BENCH_RET_CODES::LOAD_FAILED;
+
+        report["board"]["file"] = cl_parser.GetParam( 0 ).ToStdString();
+    }
+    else
+    {
+        board = buildSyntheticBoard( params, rng );
+
+        report["board"]["nets"]           = params.m_Nets;
+        report["board"]["pads_per_net"]   = params.m_PadsPerNet;
+        report["board"]["giant_net_pads"] = params.m_GiantNetPads;
+        report["board"]["unrouted_pct"]   = params.m_UnroutedPercent;
+        report["board"]["seed"]           = seed;
+    }
+
+    std::vector<BENCH_EDIT> edits;
+    wxString                replayFile;
+    wxString                recordFile;
+
+    if( cl_parser.Found( "replay", &replayFile ) )
+    {
+        if( !readEdits( replayFile.ToStdString(), edits ) )
+        {
+            std::cerr << "Cannot read edit sequence " << replayFile << std::endl;
+            return CONN_BENCH_RET_CODES::REPLAY_FAILED;
+        }
+    }
+
+    long padCount = 0;
+
+    for( FOOTPRINT* fp : board->Footprints() )
+        padCount += fp->Pads().size();
+
+    report["board"]["layers"]     = board->GetCopperLayerCount();
+    report["board"]["footprints"] = board->Footprints().size();
+    report["board"]["pads"]       = padCount;
+    report["board"]["tracks"]     = board->Tracks().size();
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = board->GetConnectivity();
+    CONN_BENCH_STAGE                   build, propagate, ratsnest, dynamic, edit;
+
+    for( long i = 0; i < reps; i++ )
+    {
+        measure( build, [&]() { connectivity->Build( board.get() ); } );
+        measure( propagate, [&]() { connectivity->PropagateNets(); } );
+
+        for( int net = 0; net < connectivity->GetNetCount(); net++ )
+            connectivity->GetConnectivityAlgo()->MarkNetAsDirty( net );
+
+        measure( ratsnest, [&]() { connectivity->RecalculateRatsnest(); } );
+    }
+
+    report["unconnected"] = connectivity->GetUnconnectedCount();
+
+    // Drag a block of footprints around, as the move tool does
+    if( dynamicSteps > 0 && !board->Footprints().empty() )
+    {
+        std::vector<BOARD_ITEM*> items;
+        size_t                   fpCount = std::min<size_t>( 16, board->Footprints().size() );
+
+        for( size_t i = 0; i < fpCount; i++ )
+        {
+            for( PAD* pad : board->Footprints()[i]->Pads() )
+                items.push_back( pad );
+        }
+
+        auto dynamicData = std::make_shared<CONNECTIVITY_DATA>( items, true );
+        connectivity->BlockRatsnestItems( items );
+
+        for( long step = 0; step < dynamicSteps; step++ )
+        {
+            dynamicData->Move( VECTOR2I( g_pitch / 4, g_pitch / 8 ) );
+
+            measure( dynamic,
+                     [&]() { connectivity->ComputeDynamicRatsnest( items, dynamicData.get() ); } );
+        }
+
+        connectivity->ClearDynamicRatsnest();
+        connectivity->Build( board.get() );
+    }
+
+    std::ofstream recordStream;
+
+    if( cl_parser.Found( "record", &recordFile ) )
+    {
+        recordStream.open( recordFile.ToStdString() );
+        recordStream << "# connectivity_benchmark edit sequence" << std::endl;
+    }
+
+    size_t skippedEdits = 0;
+    size_t editTotal = replayFile.IsEmpty() ? editCount : edits.size();
+
+    for( size_t i = 0; i < editTotal; i++ )
+    {
+        BENCH_EDIT e = replayFile.IsEmpty() ? randomEdit( *board, rng ) : edits[i];
+
+        if( recordStream.is_open() )
+            writeEdit( recordStream, e );
+
+        bool applied = true;
+
+        measure( edit,
+                 [&]()
+                 {
+                     applied = applyEdit( *board, e );
+                     connectivity->RecalculateRatsnest();
+                 } );
+
+        if( !applied )
+            skippedEdits++;
+    }
+
+    report["stages"]["build"]             = build.ToJson();
+    report["stages"]["propagate_nets"]    = propagate.ToJson();
+    report["stages"]["ratsnest"]          = ratsnest.ToJson();
+    report["stages"]["dynamic_ratsnest"]  = dynamic.ToJson();
+    report["stages"]["edit"]              = edit.ToJson();
+    report["skipped_edits"]               = skippedEdits;
+    report["peak_rss_kb"]                 = KI_TEST::GetPeakRssKb();
+
+    wxString outputFile;
+
+    if( cl_parser.Found( "output", &outputFile ) )
+    {
+        std::ofstream out( outputFile.ToStdString() );
+        out << report.dump( 2 ) << std::endl;
+    }
+    else
+    {
+        std::cout << report.dump( 2 ) << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "connectivity_benchmark",
+        "Benchmark the connectivity and ratsnest engine on synthetic boards",
+        connectivity_benchmark_main,
+} );
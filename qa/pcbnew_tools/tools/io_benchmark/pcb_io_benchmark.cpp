@@ -0,0 +1,146 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/io_benchmark.h>
+#include <qa_utils/utility_registry.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include <wx/filename.h>
+
+#include <board.h>
+#include <footprint.h>
+#include <io_mgr.h>
+#include <wildcards_and_files_ext.h>
+
+
+#ifndef QA_DATA_LOCATION
+    #define QA_DATA_LOCATION "???"
+#endif
+
+
+/**
+ * Count the items of \a aBoard, including the children of footprints.
+ */
+static uint64_t countItems( const BOARD& aBoard )
+{
+    uint64_t count = aBoard.Tracks().size() + aBoard.Drawings().size() + aBoard.Zones().size();
+
+    for( const FOOTPRINT* fp : aBoard.Footprints() )
+        count += 1 + fp->Pads().size() + fp->GraphicalItems().size() + fp->Zones().size();
+
+    return count;
+}
+
+
+/**
+ * A board file format, loaded and saved through #IO_MGR.
+ */
+class PCB_BENCH_FORMAT : public KI_TEST::IO_BENCH_FORMAT
+{
+public:
+    PCB_BENCH_FORMAT( IO_MGR::PCB_FILE_T aType, const wxString& aExtension,
+                      const char* aHeader = nullptr ) :
+            m_type( aType ),
+            m_extension( aExtension ),
+            m_header( aHeader )
+    { }
+
+    std::string GetName() const override
+    {
+        return IO_MGR::ShowType( m_type ).ToStdString();
+    }
+
+    bool CanRead( const wxFileName& aFile ) const override
+    {
+        if( aFile.GetExt() != m_extension )
+            return false;
+
+        // Other tools use the same extension (e.g. Eagle .brd files).
+        if( m_header )
+        {
+            std::ifstream in( aFile.GetFullPath().ToStdString() );
+            std::string   line;
+
+            return std::getline( in, line )
+                   && line.compare( 0, strlen( m_header ), m_header ) == 0;
+        }
+
+        return true;
+    }
+
+    bool CanSave() const override
+    {
+        return m_type == IO_MGR::KICAD_SEXP;
+    }
+
+    void Load( const wxString& aFile, KI_TEST::IO_BENCH_COUNTS& aCounts ) override
+    {
+        m_board.reset( IO_MGR::Load( m_type, aFile ) );
+
+        aCounts.m_Bytes = wxFileName::GetSize( aFile ).GetValue();
+        aCounts.m_Items = countItems( *m_board );
+    }
+
+    void Save( const wxString& aFile, KI_TEST::IO_BENCH_COUNTS& aCounts ) override
+    {
+        IO_MGR::Save( m_type, aFile, m_board.get() );
+
+        aCounts.m_Bytes = wxFileName::GetSize( aFile ).GetValue();
+        aCounts.m_Items = countItems( *m_board );
+    }
+
+    void Unload() override
+    {
+        m_board.reset();
+    }
+
+private:
+    IO_MGR::PCB_FILE_T     m_type;
+    wxString               m_extension;
+    const char*            m_header;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+int pcb_io_benchmark_func( int argc, char** argv )
+{
+    std::vector<std::unique_ptr<KI_TEST::IO_BENCH_FORMAT>> formats;
+
+    formats.push_back( std::make_unique<PCB_BENCH_FORMAT>( IO_MGR::KICAD_SEXP,
+                                                           KiCadPcbFileExtension ) );
+    formats.push_back( std::make_unique<PCB_BENCH_FORMAT>( IO_MGR::LEGACY,
+                                                           LegacyPcbFileExtension,
+                                                           "PCBNEW-BOARD" ) );
+
+    return KI_TEST::RunIoBenchmark( argc, argv, formats, { QA_DATA_LOCATION } );
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pcb_io_benchmark",
+        "Benchmark loading and saving of board files",
+        pcb_io_benchmark_func,
+} );
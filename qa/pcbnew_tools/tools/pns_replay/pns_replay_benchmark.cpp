@@ -0,0 +1,645 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#include <wx/cmdline.h>
+
+#include <board.h>
+#include <footprint.h>
+#include <pad.h>
+#include <profile.h>
+#include <track.h>
+
+#include <router/pns_debug_decorator.h>
+#include <router/pns_item.h>
+#include <router/pns_joint_map.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_logger.h>
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/pns_sizes_settings.h>
+
+
+/**
+ * Latencies of the replayed events of one type.
+ */
+struct REPLAY_STAGE
+{
+    std::vector<double> m_timesMs;
+
+    nlohmann::json ToJson() const
+    {
+        if( m_timesMs.empty() )
+            return nlohmann::json();
+
+        std::vector<double> sorted = m_timesMs;
+        std::sort( sorted.begin(), sorted.end() );
+
+        auto percentile =
+                [&]( double aFraction )
+                {
+                    size_t idx = std::min( sorted.size() - 1,
+                                           static_cast<size_t>( aFraction * sorted.size() ) );
+                    return sorted[idx];
+                };
+
+        double total = 0.0;
+
+        for( double t : sorted )
+            total += t;
+
+        nlohmann::json stage;
+
+        stage["events"]   = sorted.size();
+        stage["p50_ms"]   = percentile( 0.5 );
+        stage["p99_ms"]   = percentile( 0.99 );
+        stage["max_ms"]   = sorted.back();
+        stage["total_ms"] = total;
+
+        return stage;
+    }
+};
+
+
+/**
+ * Statistics of a replayed session.
+ */
+struct REPLAY_RESULT
+{
+    REPLAY_STAGE m_all;
+    REPLAY_STAGE m_start;
+    REPLAY_STAGE m_move;
+    REPLAY_STAGE m_fix;
+    size_t       m_failedStarts = 0;
+    size_t       m_missingItems = 0;
+};
+
+
+/**
+ * Replay \a aEvents on a router world synchronized from \a aBoard.
+ *
+ * The board itself is not modified: fixed routes are committed to the router world only, so
+ * that the following events see them, as they would in the editor.
+ */
+static void replaySession( BOARD& aBoard, const std::vector<PNS::LOGGER::EVENT_ENTRY>& aEvents,
+                           PNS::PNS_MODE aMode, REPLAY_RESULT& aResult )
+{
+    PNS_KICAD_IFACE_BASE iface;
+
+    iface.SetBoard( &aBoard );
+
+    // Some algorithms draw on the decorator unconditionally; the interface owns it
+    iface.SetDebugDecorator( new PNS::DEBUG_DECORATOR );
+
+    PNS::ROUTING_SETTINGS settings( nullptr, "" );
+    settings.SetMode( aMode );
+
+    PNS::ROUTER router;
+    router.SetInterface( &iface );
+    router.ClearWorld();
+    router.SyncWorld();
+    router.LoadSettings( &settings );
+    router.SetMode( PNS::PNS_MODE_ROUTE_SINGLE );
+
+    std::map<KIID, BOARD_ITEM*> itemsById;
+
+    for( TRACK* track : aBoard.Tracks() )
+        itemsById[track->m_Uuid] = track;
+
+    for( FOOTPRINT* footprint : aBoard.Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+            itemsById[pad->m_Uuid] = pad;
+    }
+
+    auto findItem =
+            [&]( const KIID& aId ) -> PNS::ITEM*
+            {
+                if( aId == niluuid )
+                    return nullptr;
+
+                auto it = itemsById.find( aId );
+
+                // Items created during the logged session are not part of the board
+                if( it == itemsById.end() )
+                {
+                    aResult.m_missingItems++;
+                    return nullptr;
+                }
+
+                return router.GetWorld()->FindItemByParent( it->second );
+            };
+
+    for( const PNS::LOGGER::EVENT_ENTRY& evt : aEvents )
+    {
+        PNS::ITEM*    item = findItem( evt.uuid );
+        REPLAY_STAGE* stage = nullptr;
+        PROF_COUNTER  timer;
+
+        switch( evt.type )
+        {
+        case PNS::LOGGER::EVT_START_ROUTE:
+        {
+            // The routing layer is not logged; start on the layer of the item, as the
+            // router tool does when the item is not on the current layer.
+            int layer = F_Cu;
+
+            if( item && !item->Layers().IsMultilayer() )
+                layer = item->Layers().Start();
+
+            PNS::SIZES_SETTINGS sizes( router.Sizes() );
+            iface.ImportSizes( sizes, item, -1 );
+            sizes.AddLayerPair( F_Cu, B_Cu );
+            router.UpdateSizes( sizes );
+
+            timer.Start();
+
+            if( !router.StartRouting( evt.p, item, layer ) )
+                aResult.m_failedStarts++;
+
+            stage = &aResult.m_start;
+            break;
+        }
+
+        case PNS::LOGGER::EVT_START_DRAG:
+            timer.Start();
+
+            if( !item || !router.StartDragging( evt.p, item, PNS::DM_ANY ) )
+                aResult.m_failedStarts++;
+
+            stage = &aResult.m_start;
+            break;
+
+        case PNS::LOGGER::EVT_MOVE:
+            timer.Start();
+            router.Move( evt.p, item );
+            stage = &aResult.m_move;
+            break;
+
+        case PNS::LOGGER::EVT_FIX:
+            timer.Start();
+
+            if( router.RoutingInProgress() )
+                router.FixRoute( evt.p, item );
+
+            stage = &aResult.m_fix;
+            break;
+
+        case PNS::LOGGER::EVT_ABORT:
+            router.StopRouting();
+            break;
+        }
+
+        timer.Stop();
+
+        if( stage )
+        {
+            stage->m_timesMs.push_back( timer.msecs() );
+            aResult.m_all.m_timesMs.push_back( timer.msecs() );
+        }
+    }
+
+    router.StopRouting();
+}
+
+
+/**
+ * A joint map operation of a recorded session.  Maps are numbered in the order they were
+ * created in.
+ */
+struct JOINT_MAP_TRACE_OP
+{
+    static constexpr size_t NO_MAP = std::numeric_limits<size_t>::max();
+
+    PNS::JOINT_MAP::OP::TYPE m_type;
+    size_t                   m_map;
+    size_t                   m_source;      ///< The map copied by a CREATE, or NO_MAP
+    PNS::JOINT::HASH_TAG     m_tag;
+    LAYER_RANGE              m_layers;
+};
+
+
+/**
+ * Records the operations of all the joint maps of the router.  Parallel router tasks use
+ * their maps concurrently; their operations are recorded in the order they were made in.
+ */
+class JOINT_MAP_RECORDER : public PNS::JOINT_MAP::OBSERVER
+{
+public:
+    void Record( const PNS::JOINT_MAP::OP& aOp ) override
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        JOINT_MAP_TRACE_OP op{ aOp.m_Type, 0, JOINT_MAP_TRACE_OP::NO_MAP, aOp.m_Tag,
+                               aOp.m_Layers };
+
+        if( aOp.m_Type == PNS::JOINT_MAP::OP::CREATE )
+        {
+            op.m_map = m_ids[aOp.m_Map] = m_nextId++;
+
+            if( aOp.m_Source )
+                op.m_source = mapId( aOp.m_Source );
+        }
+        else
+        {
+            op.m_map = mapId( aOp.m_Map );
+
+            if( aOp.m_Type == PNS::JOINT_MAP::OP::DESTROY )
+                m_ids.erase( aOp.m_Map );
+        }
+
+        m_trace.push_back( op );
+    }
+
+    const std::vector<JOINT_MAP_TRACE_OP>& GetTrace() const { return m_trace; }
+
+    size_t GetMapCount() const { return m_nextId; }
+
+private:
+    size_t mapId( const PNS::JOINT_MAP* aMap )
+    {
+        auto it = m_ids.find( aMap );
+
+        if( it != m_ids.end() )
+            return it->second;
+
+        // A map created before recording started: replay it as an empty one
+        size_t id = m_nextId++;
+
+        m_ids[aMap] = id;
+        m_trace.push_back( { PNS::JOINT_MAP::OP::CREATE, id, JOINT_MAP_TRACE_OP::NO_MAP,
+                             PNS::JOINT::HASH_TAG(), LAYER_RANGE() } );
+        return id;
+    }
+
+    std::mutex                                           m_mutex;
+    std::unordered_map<const PNS::JOINT_MAP*, size_t>    m_ids;
+    size_t                                               m_nextId = 0;
+    std::vector<JOINT_MAP_TRACE_OP>                      m_trace;
+};
+
+
+/**
+ * The joint map of NODE before PNS::JOINT_MAP: a std::unordered_multimap of joints searched
+ * with equal_range().  Kept as the baseline of the joint map benchmark.
+ */
+class OLD_JOINT_MAP
+{
+public:
+    PNS::JOINT* Find( const PNS::JOINT::HASH_TAG& aTag, int aLayer )
+    {
+        auto range = m_joints.equal_range( aTag );
+
+        for( auto it = range.first; it != range.second; ++it )
+        {
+            if( it->second.Layers().Overlaps( aLayer ) )
+                return &it->second;
+        }
+
+        return nullptr;
+    }
+
+    bool Contains( const PNS::JOINT::HASH_TAG& aTag ) const
+    {
+        return m_joints.find( aTag ) != m_joints.end();
+    }
+
+    template <class FUNC>
+    void ForEach( const PNS::JOINT::HASH_TAG& aTag, FUNC aFunc )
+    {
+        auto range = m_joints.equal_range( aTag );
+
+        for( auto it = range.first; it != range.second; ++it )
+            aFunc( it->second );
+    }
+
+    PNS::JOINT& Insert( const PNS::JOINT& aJoint )
+    {
+        return m_joints.emplace( aJoint.Tag(), aJoint )->second;
+    }
+
+    bool Take( const PNS::JOINT::HASH_TAG& aTag, const LAYER_RANGE& aLayers )
+    {
+        auto range = m_joints.equal_range( aTag );
+
+        for( auto it = range.first; it != range.second; ++it )
+        {
+            if( aLayers.Overlaps( it->second.Layers() ) )
+            {
+                m_joints.erase( it );
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    std::unordered_multimap<PNS::JOINT::HASH_TAG, PNS::JOINT, PNS::JOINT::JOINT_TAG_HASH> m_joints;
+};
+
+
+static void insertJoint( PNS::JOINT_MAP& aMap, const PNS::JOINT& aJoint )
+{
+    aMap.Insert( std::make_unique<PNS::JOINT>( aJoint ) );
+}
+
+
+static void insertJoint( OLD_JOINT_MAP& aMap, const PNS::JOINT& aJoint )
+{
+    aMap.Insert( aJoint );
+}
+
+
+/**
+ * Replay a joint map trace on maps of type \a MAP.
+ *
+ * Joints are inserted without their links, so the maps only hold their tags and layers.
+ *
+ * @param aHits is set to the number of joints found, visited or removed, which is the same
+ *              for all map types.
+ * @return the time taken, in milliseconds.
+ */
+template <class MAP>
+static double replayJointMapTrace( const std::vector<JOINT_MAP_TRACE_OP>& aTrace,
+                                   size_t aMapCount, size_t& aHits )
+{
+    std::vector<std::unique_ptr<MAP>> maps( aMapCount );
+    PROF_COUNTER                      timer;
+
+    aHits = 0;
+
+    for( const JOINT_MAP_TRACE_OP& op : aTrace )
+    {
+        std::unique_ptr<MAP>& map = maps[op.m_map];
+
+        switch( op.m_type )
+        {
+        case PNS::JOINT_MAP::OP::CREATE:
+            if( op.m_source == JOINT_MAP_TRACE_OP::NO_MAP )
+                map = std::make_unique<MAP>();
+            else
+                map = std::make_unique<MAP>( *maps[op.m_source] );
+
+            break;
+
+        case PNS::JOINT_MAP::OP::DESTROY:
+            map.reset();
+            break;
+
+        case PNS::JOINT_MAP::OP::FIND:
+            if( map->Find( op.m_tag, op.m_layers.Start() ) )
+                aHits++;
+
+            break;
+
+        case PNS::JOINT_MAP::OP::CONTAINS:
+            if( map->Contains( op.m_tag ) )
+                aHits++;
+
+            break;
+
+        case PNS::JOINT_MAP::OP::FOR_EACH:
+            map->ForEach( op.m_tag,
+                          [&]( PNS::JOINT& )
+                          {
+                              aHits++;
+                          } );
+            break;
+
+        case PNS::JOINT_MAP::OP::INSERT:
+            insertJoint( *map, PNS::JOINT( op.m_tag.pos, op.m_layers, op.m_tag.net ) );
+            break;
+
+        case PNS::JOINT_MAP::OP::TAKE:
+            if( map->Take( op.m_tag, op.m_layers ) )
+                aHits++;
+
+            break;
+        }
+    }
+
+    // The maps still alive at the end of the session are destroyed too
+    maps.clear();
+
+    timer.Stop();
+    return timer.msecs();
+}
+
+
+/**
+ * Time the joint map operations of \a aRecorder on PNS::JOINT_MAP and on OLD_JOINT_MAP,
+ * keeping the best of \a aReps replays of each.
+ */
+static nlohmann::json benchmarkJointMaps( const JOINT_MAP_RECORDER& aRecorder, long aReps )
+{
+    double bestNew = std::numeric_limits<double>::max();
+    double bestOld = std::numeric_limits<double>::max();
+    size_t hitsNew = 0;
+    size_t hitsOld = 0;
+
+    for( long i = 0; i < aReps; i++ )
+    {
+        bestNew = std::min( bestNew, replayJointMapTrace<PNS::JOINT_MAP>( aRecorder.GetTrace(),
+                                                                          aRecorder.GetMapCount(),
+                                                                          hitsNew ) );
+        bestOld = std::min( bestOld, replayJointMapTrace<OLD_JOINT_MAP>( aRecorder.GetTrace(),
+                                                                        aRecorder.GetMapCount(),
+                                                                        hitsOld ) );
+    }
+
+    nlohmann::json result;
+
+    result["operations"]             = aRecorder.GetTrace().size();
+    result["maps"]                   = aRecorder.GetMapCount();
+    result["open_addressing_ms"]     = bestNew;
+    result["unordered_multimap_ms"]  = bestOld;
+    result["hits"]                   = hitsNew;
+    result["hits_match"]             = hitsNew == hitsOld;
+
+    return result;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters",
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "m", "mode", "routing mode: walkaround (default), shove or mark",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "r", "reps", "replays of the session (default 1)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_SWITCH, "j", "joint-maps",
+            "also record the joint map operations of the session, and time them on the "
+            "current joint map and on the former unordered_multimap" },
+    { wxCMD_LINE_OPTION, "o", "output", "write the JSON report to this file instead of stdout",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, "board file", wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, "router event log", wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum PNS_REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    LOG_FAILED,
+};
+
+
+int pns_replay_benchmark_main( int argc, char** argv )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( "Replay a router event log, as saved by PNS::LOGGER, against the board "
+                            "it was recorded on, without the GUI.  Report the latency of the "
+                            "events, shove iterations and collision queries as JSON." );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    if( cl_parser.GetParamCount() != 2 )
+    {
+        cl_parser.Usage();
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    PNS::PNS_MODE mode = PNS::RM_Walkaround;
+    wxString      modeName = "walkaround";
+    long          reps = 1;
+
+    cl_parser.Found( "reps", &reps );
+
+    if( cl_parser.Found( "mode", &modeName ) )
+    {
+        if( modeName == "walkaround" )
+            mode = PNS::RM_Walkaround;
+        else if( modeName == "shove" )
+            mode = PNS::RM_Shove;
+        else if( modeName == "mark" )
+            mode = PNS::RM_MarkObstacles;
+        else
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    if( reps < 1 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    std::string boardFile = cl_parser.GetParam( 0 ).ToStdString();
+    std::string logFile = cl_parser.GetParam( 1 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( boardFile );
+
+    if( !board )
+        return PNS_REPLAY_RET_CODES::LOAD_FAILED;
+
+    board->BuildConnectivity();
+
+    PNS::LOGGER log;
+
+    if( !log.Load( logFile ) )
+    {
+        std::cerr << "Cannot read router event log " << logFile << std::endl;
+        return PNS_REPLAY_RET_CODES::LOG_FAILED;
+    }
+
+    PNS::PERF_COUNTERS& counters = PNS::PERF_COUNTERS::Instance();
+    REPLAY_RESULT       result;
+    JOINT_MAP_RECORDER  jointMapRecorder;
+    bool                benchmarkJoints = cl_parser.Found( "joint-maps" );
+
+    if( benchmarkJoints )
+    {
+        // A separate session, so that recording does not slow down the timed ones
+        REPLAY_RESULT recordedResult;
+
+        PNS::JOINT_MAP::SetObserver( &jointMapRecorder );
+        replaySession( *board, log.GetEvents(), mode, recordedResult );
+        PNS::JOINT_MAP::SetObserver( nullptr );
+    }
+
+    counters.Reset();
+
+    for( long i = 0; i < reps; i++ )
+        replaySession( *board, log.GetEvents(), mode, result );
+
+    nlohmann::json report;
+
+    report["board"]               = boardFile;
+    report["log"]                 = logFile;
+    report["mode"]                = modeName.ToStdString();
+    report["reps"]                = reps;
+    report["events"]              = log.GetEvents().size();
+    report["latency"]["all"]      = result.m_all.ToJson();
+    report["latency"]["start"]    = result.m_start.ToJson();
+    report["latency"]["move"]     = result.m_move.ToJson();
+    report["latency"]["fix"]      = result.m_fix.ToJson();
+    report["failed_starts"]       = result.m_failedStarts;
+    report["missing_items"]       = result.m_missingItems;
+    report["shove_iterations"]    = counters.m_ShoveIterations.load();
+    report["collision_queries"]   = counters.m_CollisionQueries.load();
+
+    if( benchmarkJoints )
+        report["joint_maps"] = benchmarkJointMaps( jointMapRecorder, reps );
+
+    wxString outputFile;
+
+    if( cl_parser.Found( "output", &outputFile ) )
+    {
+        std::ofstream out( outputFile.ToStdString() );
+        out << report.dump( 2 ) << std::endl;
+    }
+    else
+    {
+        std::cout << report.dump( 2 ) << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pns_replay_benchmark",
+        "Replay a router event log headlessly and report routing latencies",
+        pns_replay_benchmark_main,
+} );
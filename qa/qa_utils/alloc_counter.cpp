@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file alloc_counter.cpp
+ * Replacement global operator new which counts heap allocations for KI_TEST::GetAllocStats().
+ *
+ * This file is not part of the qa_utils library: replacing operator new affects the whole
+ * program, so it is added to the sources of the executables which want allocation counts.
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include <qa_utils/io_benchmark.h>
+
+
+static void* countedAlloc( std::size_t aSize )
+{
+    KI_TEST::RecordAllocation( aSize );
+
+    if( aSize == 0 )
+        aSize = 1;
+
+    while( true )
+    {
+        if( void* ptr = std::malloc( aSize ) )
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+
+        if( !handler )
+            throw std::bad_alloc();
+
+        handler();
+    }
+}
+
+
+void* operator new( std::size_t aSize )
+{
+    return countedAlloc( aSize );
+}
+
+
+void* operator new[]( std::size_t aSize )
+{
+    return countedAlloc( aSize );
+}
+
+
+void* operator new( std::size_t aSize, const std::nothrow_t& ) noexcept
+{
+    try
+    {
+        return countedAlloc( aSize );
+    }
+    catch( const std::bad_alloc& )
+    {
+        return nullptr;
+    }
+}
+
+
+void* operator new[]( std::size_t aSize, const std::nothrow_t& ) noexcept
+{
+    try
+    {
+        return countedAlloc( aSize );
+    }
+    catch( const std::bad_alloc& )
+    {
+        return nullptr;
+    }
+}
+
+
+void operator delete( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete( void* aPtr, std::size_t ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr, std::size_t ) noexcept
+{
+    std::free( aPtr );
+}
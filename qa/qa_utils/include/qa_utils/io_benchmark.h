@@ -0,0 +1,143 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file io_benchmark.h
+ * Shared harness for the file format load/save benchmark utilities.
+ */
+
+#ifndef QA_UTILS_IO_BENCHMARK_H
+#define QA_UTILS_IO_BENCHMARK_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/filename.h>
+#include <wx/string.h>
+
+
+namespace KI_TEST
+{
+
+/**
+ * Heap allocation counters.
+ *
+ * These are only advanced in executables which also compile qa_utils/alloc_counter.cpp,
+ * which replaces the global operator new.
+ */
+struct ALLOC_STATS
+{
+    uint64_t m_Count;       ///< Number of allocations.
+    uint64_t m_Bytes;       ///< Number of bytes allocated.
+};
+
+
+/// Record one heap allocation of \a aSize bytes.
+void RecordAllocation( size_t aSize );
+
+/// @return the allocations made since the program started.
+ALLOC_STATS GetAllocStats();
+
+/**
+ * @return the peak resident set size of the process since it started, in kilobytes, or 0 if
+ *         unknown.  It never decreases, so it cannot measure a single operation.
+ */
+uint64_t GetPeakRssKb();
+
+
+/**
+ * The size of a document, as counted by an #IO_BENCH_FORMAT.
+ */
+struct IO_BENCH_COUNTS
+{
+    IO_BENCH_COUNTS() :
+            m_Bytes( 0 ),
+            m_Items( 0 )
+    { }
+
+    uint64_t m_Bytes;       ///< Size of the file(s) read or written.
+    uint64_t m_Items;       ///< Number of items in the document.
+};
+
+
+/**
+ * A file format exercised by the I/O benchmark.
+ *
+ * Implementations wrap the plugin of one file format and hold the document loaded last.
+ */
+class IO_BENCH_FORMAT
+{
+public:
+    virtual ~IO_BENCH_FORMAT() {}
+
+    /// Short name of the format, used in the report.
+    virtual std::string GetName() const = 0;
+
+    /// @return true if \a aFile is a file of this format.
+    virtual bool CanRead( const wxFileName& aFile ) const = 0;
+
+    /// @return true if the format can also be written.
+    virtual bool CanSave() const = 0;
+
+    /// Set up anything \a aFile needs before it is loaded, such as its project.  This is not
+    /// timed.
+    virtual void Prepare( const wxString& aFile ) {}
+
+    /**
+     * Load \a aFile, replacing the current document.
+     *
+     * @throw IO_ERROR if the file cannot be loaded.
+     */
+    virtual void Load( const wxString& aFile, IO_BENCH_COUNTS& aCounts ) = 0;
+
+    /**
+     * Save the current document to \a aFile.
+     *
+     * @throw IO_ERROR if the document cannot be saved.
+     */
+    virtual void Save( const wxString& aFile, IO_BENCH_COUNTS& aCounts ) = 0;
+
+    /// Free the current document.  This is not timed.
+    virtual void Unload() = 0;
+};
+
+
+/**
+ * Run the load/save benchmark over files given on the command line.
+ *
+ * The command line is "[-r REPS] [-o JSON_FILE] [FILES_OR_DIRS...]".  Directories are
+ * searched recursively, and \a aDefaultPaths are used when no file is given.  Each file
+ * read by one of \a aFormats is loaded and, if possible, saved \a REPS times, and the
+ * results are written as JSON.
+ *
+ * @return a KI_TEST::RET_CODES value.
+ */
+int RunIoBenchmark( int argc, char** argv,
+                    const std::vector<std::unique_ptr<IO_BENCH_FORMAT>>& aFormats,
+                    const std::vector<wxString>& aDefaultPaths );
+
+} // namespace KI_TEST
+
+#endif // QA_UTILS_IO_BENCHMARK_H
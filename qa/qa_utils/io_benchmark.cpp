@@ -0,0 +1,306 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/io_benchmark.h>
+#include <qa_utils/utility_program.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+
+#include <nlohmann/json.hpp>
+
+#include <wx/cmdline.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+
+#include <ki_exception.h>
+#include <profile.h>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+
+namespace KI_TEST
+{
+
+// Constant initialized, so allocations made during static initialization are safe to count.
+static std::atomic<uint64_t> g_allocCount( 0 );
+static std::atomic<uint64_t> g_allocBytes( 0 );
+
+
+void RecordAllocation( size_t aSize )
+{
+    g_allocCount.fetch_add( 1, std::memory_order_relaxed );
+    g_allocBytes.fetch_add( aSize, std::memory_order_relaxed );
+}
+
+
+ALLOC_STATS GetAllocStats()
+{
+    return { g_allocCount.load(), g_allocBytes.load() };
+}
+
+
+uint64_t GetPeakRssKb()
+{
+#if defined( _WIN32 )
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+        return counters.PeakWorkingSetSize / 1024;
+
+    return 0;
+#else
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+        return 0;
+
+#if defined( __APPLE__ )
+    return usage.ru_maxrss / 1024;      // bytes on macOS
+#else
+    return usage.ru_maxrss;             // kilobytes elsewhere
+#endif
+#endif
+}
+
+
+/**
+ * The measurements of one operation (load or save) over all repetitions.
+ */
+struct IO_BENCH_OP
+{
+    std::vector<double> m_timesMs;
+    IO_BENCH_COUNTS     m_counts;
+    ALLOC_STATS         m_allocs = { 0, 0 };
+
+    nlohmann::json ToJson() const
+    {
+        std::vector<double> sorted = m_timesMs;
+        std::sort( sorted.begin(), sorted.end() );
+
+        double median = sorted[ sorted.size() / 2 ];
+        double seconds = median / 1000.0;
+        double reps = sorted.size();
+
+        nlohmann::json op;
+
+        op["min_ms"]          = sorted.front();
+        op["median_ms"]       = median;
+        op["max_ms"]          = sorted.back();
+        op["bytes"]           = m_counts.m_Bytes;
+        op["items"]           = m_counts.m_Items;
+        op["mb_per_s"]        = seconds > 0.0 ? m_counts.m_Bytes / 1.0e6 / seconds : 0.0;
+        op["items_per_s"]     = seconds > 0.0 ? m_counts.m_Items / seconds : 0.0;
+        op["allocations"]     = m_allocs.m_Count / reps;
+        op["allocated_bytes"] = m_allocs.m_Bytes / reps;
+
+        return op;
+    }
+};
+
+
+static void findFiles( const wxString& aPath,
+                       const std::vector<std::unique_ptr<IO_BENCH_FORMAT>>& aFormats,
+                       std::vector<std::pair<wxString, IO_BENCH_FORMAT*>>& aFiles )
+{
+    wxArrayString candidates;
+
+    if( wxDirExists( aPath ) )
+        wxDir::GetAllFiles( aPath, &candidates );
+    else
+        candidates.Add( aPath );
+
+    candidates.Sort();
+
+    for( const wxString& candidate : candidates )
+    {
+        for( const std::unique_ptr<IO_BENCH_FORMAT>& format : aFormats )
+        {
+            if( format->CanRead( candidate ) )
+            {
+                aFiles.emplace_back( candidate, format.get() );
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * Time \a aFunc, adding its duration and allocations to \a aOp.
+ */
+template <typename FUNC>
+static void measure( IO_BENCH_OP& aOp, FUNC aFunc )
+{
+    ALLOC_STATS before = GetAllocStats();
+    PROF_COUNTER timer;
+
+    aFunc();
+
+    timer.Stop();
+
+    ALLOC_STATS after = GetAllocStats();
+
+    aOp.m_timesMs.push_back( timer.msecs() );
+    aOp.m_allocs.m_Count += after.m_Count - before.m_Count;
+    aOp.m_allocs.m_Bytes += after.m_Bytes - before.m_Bytes;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters",
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "r", "reps", "number of repetitions of each file (default 5)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "o", "output", "write the JSON report to this file instead of stdout",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, "input files or directories", wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum IO_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    NO_FILES,
+};
+
+
+int RunIoBenchmark( int argc, char** argv,
+                    const std::vector<std::unique_ptr<IO_BENCH_FORMAT>>& aFormats,
+                    const std::vector<wxString>& aDefaultPaths )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( "Load and save each file the given number of times and report "
+                            "throughput, allocations and peak memory use as JSON." );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long reps = 5;
+    cl_parser.Found( "reps", &reps );
+
+    if( reps < 1 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    std::vector<std::pair<wxString, IO_BENCH_FORMAT*>> files;
+
+    if( cl_parser.GetParamCount() == 0 )
+    {
+        for( const wxString& path : aDefaultPaths )
+            findFiles( path, aFormats, files );
+    }
+    else
+    {
+        for( size_t i = 0; i < cl_parser.GetParamCount(); i++ )
+            findFiles( cl_parser.GetParam( i ), aFormats, files );
+    }
+
+    if( files.empty() )
+    {
+        std::cerr << "No files to benchmark" << std::endl;
+        return IO_BENCH_RET_CODES::NO_FILES;
+    }
+
+    wxString saveFile = wxFileName::CreateTempFileName( "io_benchmark" );
+    nlohmann::json report;
+    nlohmann::json results = nlohmann::json::array();
+    bool ok = true;
+
+    for( const std::pair<wxString, IO_BENCH_FORMAT*>& file : files )
+    {
+        IO_BENCH_FORMAT* format = file.second;
+        IO_BENCH_OP      load;
+        IO_BENCH_OP      save;
+        nlohmann::json   result;
+
+        result["file"]   = file.first.ToStdString();
+        result["format"] = format->GetName();
+
+        std::cerr << "Benchmarking " << file.first << std::endl;
+
+        try
+        {
+            format->Prepare( file.first );
+
+            for( long i = 0; i < reps; ++i )
+            {
+                measure( load, [&]() { format->Load( file.first, load.m_counts ); } );
+
+                if( format->CanSave() )
+                    measure( save, [&]() { format->Save( saveFile, save.m_counts ); } );
+
+                format->Unload();
+            }
+
+            result["load"] = load.ToJson();
+            result["save"] = format->CanSave() ? save.ToJson() : nlohmann::json();
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            format->Unload();
+            result["error"] = ioe.What().ToStdString();
+            ok = false;
+        }
+
+        results.push_back( result );
+    }
+
+    wxRemoveFile( saveFile );
+
+    report["repetitions"] = reps;
+
+    // The high-water mark of the whole process, over all the files of the run
+    report["peak_rss_kb"] = GetPeakRssKb();
+    report["results"]     = results;
+
+    wxString outputFile;
+
+    if( cl_parser.Found( "output", &outputFile ) )
+    {
+        std::ofstream out( outputFile.ToStdString() );
+        out << report.dump( 2 ) << std::endl;
+    }
+    else
+    {
+        std::cout << report.dump( 2 ) << std::endl;
+    }
+
+    return ok ? KI_TEST::RET_CODES::OK : IO_BENCH_RET_CODES::LOAD_FAILED;
+}
+
+} // namespace KI_TEST
@@ -204,6 +204,21 @@ public:
         return cnt;
     }
 
+    /// Find all overlapping any of the search rectangles, walking the tree once
+    /// \param a_rects Search rectangles.  An entry overlapping several of them is found once.
+    /// \param a_visitor Visitor called on each entry found.  Should return 'true' to continue searching
+    /// \return Returns the number of entries found
+    template <class VISITOR>
+    int Search( const std::vector<Rect>& a_rects, VISITOR& a_visitor ) const
+    {
+        int cnt = 0;
+
+        if( !a_rects.empty() )
+            Search( m_root, a_rects, a_visitor, cnt );
+
+        return cnt;
+    }
+
     /// Calculate Statistics
 
     Statistics CalcStats();
@@ -602,6 +617,47 @@ protected:
         return true; // Continue searching
     }
 
+    template <class VISITOR>
+    bool Search( const Node* a_node, const std::vector<Rect>& a_rects, VISITOR& a_visitor,
+                 int& a_foundCount ) const
+    {
+        ASSERT( a_node );
+        ASSERT( a_node->m_level >= 0 );
+
+        for( int index = 0; index < a_node->m_count; ++index )
+        {
+            const Branch& branch = a_node->m_branch[index];
+            bool          overlaps = false;
+
+            for( const Rect& rect : a_rects )
+            {
+                if( Overlap( &rect, &branch.m_rect ) )
+                {
+                    overlaps = true;
+                    break;
+                }
+            }
+
+            if( !overlaps )
+                continue;
+
+            if( a_node->IsInternalNode() ) // This is an internal node in the tree
+            {
+                if( !Search( branch.m_child, a_rects, a_visitor, a_foundCount ) )
+                    return false; // Don't continue searching
+            }
+            else // This is a leaf node
+            {
+                if( !a_visitor( branch.m_data ) )
+                    return false;
+
+                a_foundCount++;
+            }
+        }
+
+        return true; // Continue searching
+    }
+
     void    RemoveAllRec( Node* a_node ) const;
     void    Reset() const;
     void    CountRec( const Node* a_node, int& a_count ) const;